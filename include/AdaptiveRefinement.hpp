@@ -0,0 +1,100 @@
+/*Adaptive refinement and coarsening of a tree driven by a scalar field*/
+
+/*The error of a node is how badly the multilinear interpolation of the field from the node corners approximates it
+* at the corners of the node's children (the 3^D points of the node with coordinates lower, middle or upper on every axis).
+* refine() splits the leafs whose error is above the tolerance (until the tree's max depth), coarsen() merges the nodes whose
+* children are leafs and whose error is below coarsenRatio * tolerance, unless the merged node would be crowded (splits made by
+* insert for the points are kept). Both keep the tree 2:1 balanced (face neighbour
+* leafs differ by at most one level) incrementally, without a global balance() pass.
+* The field is evaluated in batches (one per tree level), split among threads, so the field function must be thread safe
+* if threads > 1. Values are cached by corner, so corners shared by neighbours and by parents and children are evaluated once;
+* call clearCache() when the field changes.
+*/
+
+#ifndef ADAPTIVEREFINEMENT_HPP
+#define ADAPTIVEREFINEMENT_HPP
+
+#include <vector>
+#include <array>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <thread>
+#include "Orthtree.hpp"
+
+namespace sim
+{
+    template <int D, typename uT, typename cT>
+    class AdaptiveRefiner
+    {
+    public:
+        typedef Orthtree<D, uT, cT> Tree;
+        typedef typename Tree::PointType PointType;
+        typedef std::function<double(const PointType&)> FieldFunction;
+
+    private:
+        typedef std::array<double, D> Corner;
+        struct CornerHash
+        {
+            size_t operator()(const Corner& corner) const
+            {
+                size_t hash = 0;
+                for (double c : corner)
+                {
+                    hash ^= std::hash<double>()(c) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+                }
+                return hash;
+            }
+        };
+        static constexpr int LATTICE_SIZE = D == 2 ? 9 : (D == 3 ? 27 : 0); // 3^D corners of the children of a node
+
+        Tree* tree;
+        FieldFunction field;
+        double tolerance;
+        double coarsenRatio; // Nodes are merged when their error is below coarsenRatio * tolerance
+        int minDepth; // Leafs above this depth are always split
+        int threads;
+        std::unordered_map<Corner, double, CornerHash> cache;
+
+        // Private methods
+        Corner getCorner(const Tree* node, int index) const; // index in base 3, digit a is the position on axis a (0 = lower, 1 = middle, 2 = upper)
+        void evaluate(const std::vector<Tree*>& nodes); // Evaluate (in parallel) the uncached corners of the nodes
+        void split(Tree* node, std::vector<Tree*>* newLeafs); // Subdivide and restore the 2:1 balance around the node
+        bool canMerge(Tree* node); // The children are all leafs, merging keeps the 2:1 balance and undoes no split made by insert
+        bool isPointSplit(Tree* node); // The pooled points of the node and its children would make insert split the node (isCrowded)
+
+    public:
+        AdaptiveRefiner(Tree* tree, FieldFunction field, double tolerance);
+
+        // Main methods
+        int refine(); // Split until every leaf is within tolerance, returns the number of subdivisions
+        int coarsen(); // Merge the nodes that are well within tolerance, returns the number of merges
+        int adapt(); // Coarsen then refine, e.g. after the field changed (call clearCache() first), returns the number of changed nodes
+        double estimateError(Tree* node); // Max interpolation error of the field at the corners of the node's children
+
+        // Getters and setters
+        double getTolerance() const { return tolerance; }
+        void setTolerance(double tolerance) { this->tolerance = tolerance; }
+        double getCoarsenRatio() const { return coarsenRatio; }
+        void setCoarsenRatio(double coarsenRatio) { this->coarsenRatio = coarsenRatio; } // Below 1, so a merged node is not split again right away
+        int getMinDepth() const { return minDepth; }
+        void setMinDepth(int minDepth) { this->minDepth = minDepth; }
+        int getThreads() const { return threads; }
+        void setThreads(int threads) { this->threads = threads; }
+        void setField(FieldFunction field) { this->field = field; cache.clear(); }
+        void clearCache() { cache.clear(); }
+        size_t getCacheSize() const { return cache.size(); }
+    };
+
+    template <typename uT, typename cT>
+    using AdaptiveQuadtreeRefiner = AdaptiveRefiner<2, uT, cT>;
+
+    template <typename uT, typename cT>
+    using AdaptiveOctreeRefiner = AdaptiveRefiner<3, uT, cT>;
+
+} // namespace sim
+
+#include "AdaptiveRefinement_impl.tpp"
+
+#endif // ADAPTIVEREFINEMENT_HPP
@@ -0,0 +1,300 @@
+namespace sim
+{
+    template <int D, typename uT, typename cT>
+    AdaptiveRefiner<D, uT, cT>::AdaptiveRefiner(Tree* tree, FieldFunction field, double tolerance) : tree(tree), field(field), tolerance(tolerance), coarsenRatio(0.25), minDepth(0), threads(1)
+    {
+    }
+
+    // Corner of a child of the node, same middle as subdivide so the corners of the children match exactly
+    template <int D, typename uT, typename cT>
+    typename AdaptiveRefiner<D, uT, cT>::Corner AdaptiveRefiner<D, uT, cT>::getCorner(const Tree* node, int index) const
+    {
+        Corner corner;
+        for (int axis = 0; axis < D; axis++, index /= 3)
+        {
+            double lower = OrthtreeSpace<D>::coord(OrthtreeSpace<D>::lower(node->boundary), axis);
+            double upper = OrthtreeSpace<D>::coord(OrthtreeSpace<D>::upper(node->boundary), axis);
+            int position = index % 3;
+            corner[axis] = position == 0 ? lower : (position == 1 ? (lower + upper) / 2 : upper);
+        }
+        return corner;
+    }
+
+    // Collect the uncached corners (once each), evaluate them in parallel chunks, then store them in the cache
+    template <int D, typename uT, typename cT>
+    void AdaptiveRefiner<D, uT, cT>::evaluate(const std::vector<Tree*>& nodes)
+    {
+        std::vector<Corner> batch;
+        for (Tree* node : nodes)
+        {
+            for (int i = 0; i < LATTICE_SIZE; i++)
+            {
+                Corner corner = getCorner(node, i);
+                if (cache.try_emplace(corner, 0.0).second)
+                {
+                    batch.push_back(corner);
+                }
+            }
+        }
+
+        std::vector<double> values(batch.size());
+        auto evaluateChunk = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                QT_STATS_COUNT(FIELD_EVALUATIONS);
+                values[i] = field(OrthtreeSpace<D>::makePoint(batch[i]));
+            }
+        };
+        size_t workers = std::min<size_t>(std::max(threads, 1), batch.size());
+        if (workers <= 1)
+        {
+            evaluateChunk(0, batch.size());
+        }
+        else
+        {
+            std::vector<std::thread> pool;
+            size_t chunk = (batch.size() + workers - 1) / workers;
+            for (size_t begin = chunk; begin < batch.size(); begin += chunk)
+            {
+                pool.emplace_back(evaluateChunk, begin, std::min(begin + chunk, batch.size()));
+            }
+            evaluateChunk(0, chunk);
+            for (std::thread& thread : pool)
+            {
+                thread.join();
+            }
+        }
+
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            cache[batch[i]] = values[i];
+        }
+    }
+
+    // Compare the field at the 3^D corners with the multilinear interpolation of the 2^D node corners
+    template <int D, typename uT, typename cT>
+    double AdaptiveRefiner<D, uT, cT>::estimateError(Tree* node)
+    {
+        evaluate(std::vector<Tree*>{ node }); // Only the corners not cached yet (e.g. shared with the children) are evaluated
+        std::array<double, LATTICE_SIZE> values;
+        for (int i = 0; i < LATTICE_SIZE; i++)
+        {
+            values[i] = cache.at(getCorner(node, i));
+        }
+
+        double error = 0;
+        for (int i = 0; i < LATTICE_SIZE; i++)
+        {
+            // Weight of node corner c (bit a set = upper on axis a) at lattice position t (0, 0.5 or 1 on every axis)
+            double interpolated = 0;
+            for (int c = 0; c < Tree::CHILDREN; c++)
+            {
+                double weight = 1;
+                int cornerIndex = 0;
+                for (int axis = 0, digits = i, power = 1; axis < D; axis++, digits /= 3, power *= 3)
+                {
+                    double t = (digits % 3) / 2.0;
+                    bool upperSide = c & (1 << axis);
+                    weight *= upperSide ? t : 1 - t;
+                    cornerIndex += (upperSide ? 2 : 0) * power;
+                }
+                interpolated += weight * values[cornerIndex];
+            }
+            error = std::max(error, std::abs(values[i] - interpolated));
+        }
+        return error;
+    }
+
+    // Refine level by level: the leafs of one level are evaluated in one batch, the ones to split produce the next level
+    template <int D, typename uT, typename cT>
+    int AdaptiveRefiner<D, uT, cT>::refine()
+    {
+        std::queue<Tree*> leafs;
+        tree->getLeafs(&leafs);
+        std::vector<Tree*> wave;
+        while (!leafs.empty())
+        {
+            wave.push_back(leafs.front());
+            leafs.pop();
+        }
+
+        int subdivisions = 0;
+        while (!wave.empty())
+        {
+            std::erase_if(wave, [](const Tree* node) { return node->depth >= node->maxDepth; });
+            evaluate(wave);
+            std::vector<Tree*> nextWave;
+            for (Tree* node : wave)
+            {
+                // Skip the leafs already split to balance a neighbour (their children are in the next wave)
+                if (node->divided || node->depth >= node->maxDepth)
+                {
+                    continue;
+                }
+                if (node->depth < minDepth || estimateError(node) > tolerance)
+                {
+                    int before = nextWave.size();
+                    split(node, &nextWave);
+                    subdivisions += (nextWave.size() - before) / Tree::CHILDREN;
+                }
+            }
+            wave.swap(nextWave);
+        }
+        return subdivisions;
+    }
+
+    // A node split at depth d has children at d + 1, so its face neighbour leafs above depth d must be split too
+    template <int D, typename uT, typename cT>
+    void AdaptiveRefiner<D, uT, cT>::split(Tree* node, std::vector<Tree*>* newLeafs)
+    {
+        node->subdivide();
+        for (int i = 0; i < Tree::CHILDREN; i++)
+        {
+            newLeafs->push_back(node->children[i]);
+        }
+        for (int axis = 0; axis < D; axis++)
+        {
+            for (bool positive : { false, true })
+            {
+                Tree* neighbour = node->getNeighbour(axis, positive);
+                if (neighbour != nullptr && !neighbour->divided && neighbour->depth < node->depth)
+                {
+                    QT_STATS_COUNT(BALANCE_SUBDIVISIONS);
+                    split(neighbour, newLeafs);
+                }
+            }
+        }
+    }
+
+    // Once merged the node is a leaf at depth d, so the children of its face neighbours that touch it must be leafs
+    template <int D, typename uT, typename cT>
+    bool AdaptiveRefiner<D, uT, cT>::canMerge(Tree* node)
+    {
+        if (!node->divided)
+        {
+            return false;
+        }
+        for (int i = 0; i < Tree::CHILDREN; i++)
+        {
+            if (node->children[i]->divided)
+            {
+                return false;
+            }
+        }
+        for (int axis = 0; axis < D; axis++)
+        {
+            for (bool positive : { false, true })
+            {
+                Tree* neighbour = node->getNeighbour(axis, positive);
+                if (neighbour == nullptr || !neighbour->divided || neighbour->depth < node->depth)
+                {
+                    continue;
+                }
+                for (int i = 0; i < Tree::CHILDREN; i++)
+                {
+                    // Children on the side facing the node: lower side of the axis for a positive neighbour
+                    bool upperSide = i & (1 << axis);
+                    if (upperSide != positive && neighbour->children[i]->divided)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return !isPointSplit(node);
+    }
+
+    // Would insert have split the merged node? Only if it was crowded before storing the last of the pooled points
+    template <int D, typename uT, typename cT>
+    bool AdaptiveRefiner<D, uT, cT>::isPointSplit(Tree* node)
+    {
+        std::vector<PointType> pooled = node->points;
+        for (int i = 0; i < Tree::CHILDREN; i++)
+        {
+            pooled.insert(pooled.end(), node->children[i]->points.begin(), node->children[i]->points.end());
+        }
+        if (pooled.empty())
+        {
+            return false;
+        }
+        pooled.pop_back();
+
+        // Evaluate isCrowded on the node as it would be once merged, then restore it
+        std::swap(node->points, pooled);
+        node->divided = false;
+        QT_STATS_COUNT(IS_CROWDED_EVALUATIONS);
+        bool crowded = node->isCrowded(node, node->isCrowdedData);
+        node->divided = true;
+        std::swap(node->points, pooled);
+        return crowded;
+    }
+
+    // Coarsen bottom up: a merged node can make its parent a candidate, which is tried in the next wave.
+    // A node blocked by the balance of a neighbour can become mergeable once the neighbour is merged, so passes are repeated until nothing changes
+    template <int D, typename uT, typename cT>
+    int AdaptiveRefiner<D, uT, cT>::coarsen()
+    {
+        int merges = 0;
+        int passMerges;
+        do
+        {
+            passMerges = 0;
+            std::vector<Tree*> wave;
+            std::vector<Tree*> toVisit;
+            toVisit.push_back(tree);
+            while (!toVisit.empty())
+            {
+                Tree* node = toVisit.back();
+                toVisit.pop_back();
+                if (!node->divided)
+                {
+                    continue;
+                }
+                bool childrenAreLeafs = true;
+                for (int i = 0; i < Tree::CHILDREN; i++)
+                {
+                    childrenAreLeafs = childrenAreLeafs && !node->children[i]->divided;
+                    toVisit.push_back(node->children[i]);
+                }
+                if (childrenAreLeafs)
+                {
+                    wave.push_back(node);
+                }
+            }
+            // Deepest first, so small nodes are merged before they could block their neighbours
+            std::stable_sort(wave.begin(), wave.end(), [](const Tree* a, const Tree* b) { return a->depth > b->depth; });
+
+            while (!wave.empty())
+            {
+                evaluate(wave);
+                std::vector<Tree*> nextWave;
+                for (Tree* node : wave)
+                {
+                    if (node->depth < minDepth || !canMerge(node) || estimateError(node) > coarsenRatio * tolerance)
+                    {
+                        continue;
+                    }
+                    node->merge();
+                    passMerges++;
+
+                    // The parent becomes a candidate when its last divided child is merged
+                    Tree* parent = node->parent;
+                    if (parent != nullptr && canMerge(parent))
+                    {
+                        nextWave.push_back(parent);
+                    }
+                }
+                wave.swap(nextWave);
+            }
+            merges += passMerges;
+        } while (passMerges > 0);
+        return merges;
+    }
+
+    template <int D, typename uT, typename cT>
+    int AdaptiveRefiner<D, uT, cT>::adapt()
+    {
+        int merges = coarsen();
+        return merges + refine();
+    }
+}
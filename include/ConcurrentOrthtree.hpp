@@ -0,0 +1,131 @@
+/*Tree for one writer and many lock-free readers*/
+
+/*Readers never block: they take a Snapshot, which pins the current version of the tree, and query it.
+* Writers copy the nodes on the paths they modify (copy-on-write), then publish the new root with one atomic store,
+* so a snapshot always sees a whole batch or nothing of it. Unmodified subtrees are shared between versions.
+* Replaced nodes are freed with epoch-based reclamation: only when no snapshot pinned before their replacement is alive.
+* Writers are serialised by a mutex (readers never touch it). Points and pointers returned by a snapshot stay valid while the snapshot lives.
+* The crowdedness criterion is the default one (a node is crowded when it holds capacity points), custom isCrowded functions are not supported.
+*/
+
+#ifndef CONCURRENTORTHTREE_HPP
+#define CONCURRENTORTHTREE_HPP
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include "Orthtree.hpp"
+
+namespace sim
+{
+    template <int D>
+    class ConcurrentOrthtree
+    {
+    public:
+        typedef typename OrthtreeSpace<D>::PointType PointType;
+        typedef typename OrthtreeSpace<D>::BoxType BoxType;
+        static constexpr int CHILDREN = 1 << D;
+
+        // Node of one version of the tree, immutable once published
+        typedef struct Node
+        {
+            BoxType boundary;
+            int depth;
+            std::vector<PointType> points;
+            std::vector<int> multiplicities; // multiplicities[i] = number of coincident points merged into points[i]
+            const Node* children[CHILDREN]; // Same child indexing as Orthtree (nullptr if not divided)
+            bool divided;
+            uint64_t version; // Batch that created the node, nodes of the batch being written can be modified in place
+
+            Node(BoxType boundary, int depth, uint64_t version) : boundary(boundary), depth(depth), divided(false), version(version)
+            {
+                for (int i = 0; i < CHILDREN; i++) { children[i] = nullptr; }
+            }
+        } Node;
+
+    private:
+        // A reader slot: records are never freed while the tree lives, so readers can claim them without locks
+        struct ReaderRecord
+        {
+            std::atomic<bool> inUse;
+            std::atomic<uint64_t> epoch; // 0 when the reader is not pinned
+            ReaderRecord* next;
+
+            ReaderRecord() : inUse(true), epoch(0), next(nullptr) {}
+        };
+
+        // Nodes replaced by a published batch, freed once no reader pinned at or before retireEpoch is alive
+        struct RetiredBatch
+        {
+            uint64_t retireEpoch;
+            std::vector<const Node*> nodes;
+        };
+
+        std::atomic<const Node*> root;
+        std::atomic<uint64_t> globalEpoch;
+        mutable std::atomic<ReaderRecord*> readers;
+        std::mutex writerMutex;
+        std::vector<RetiredBatch> retired; // Protected by writerMutex
+        std::vector<const Node*> replaced; // Nodes replaced by the batch being written, protected by writerMutex
+        uint64_t version; // Current batch, protected by writerMutex
+        int capacity;
+        int maxDepth;
+        double mergeDistance;
+
+        // Private methods
+        Node* writable(const Node* node); // Node of the current batch, copied if it belongs to a published version
+        Node* insert(const Node* node, PointType pt); // Path copying insert, returns the node replacing node
+        void subdivide(Node* node);
+        void publish(const Node* newRoot); // Make a batch visible to readers and retire the nodes it replaced
+        void reclaim(); // Free the retired nodes no reader can see anymore
+        ReaderRecord* pin() const; // Claim a reader record and pin the current epoch
+        static void deleteTree(const Node* node);
+
+    public:
+        // Pinned version of the tree, readers query it without ever blocking
+        class Snapshot
+        {
+        private:
+            ReaderRecord* record;
+            const Node* root;
+
+        public:
+            Snapshot(ReaderRecord* record, const Node* root) : record(record), root(root) {}
+            Snapshot(Snapshot&& other) noexcept : record(other.record), root(other.root) { other.record = nullptr; }
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+            ~Snapshot(); // Unpin, the nodes of this version may be freed afterwards
+
+            std::vector<const PointType*> queryRange(BoxType range) const; // Get all points inside a range
+            void getLeafs(std::vector<const Node*>* leafs) const; // Get all leafs of this version, provide a vector to store them
+            const Node* getRoot() const { return root; }
+        };
+
+        ConcurrentOrthtree(BoxType boundary, int capacity);
+        ~ConcurrentOrthtree(); // No snapshot may outlive the tree
+
+        // Main methods (writers)
+        bool insert(PointType point); // Insert and publish a single point
+        int bulkInsert(std::vector<PointType> points); // Insert and publish a batch atomically, returns how many were inserted
+
+        // Main methods (readers)
+        Snapshot snapshot() const; // Pin the current version
+        std::vector<PointType> queryRange(BoxType range) const; // One-shot query on the current version, returns copies of the points
+
+        // Getters and setters
+        int getCapacity() const { return capacity; }
+        int getMaxDepth() const { return maxDepth; }
+        double getMergeDistance() const { return mergeDistance; }
+        void setMaxDepth(int maxDepth) { this->maxDepth = maxDepth; } // Set before inserting
+        void setMergeDistance(double mergeDistance) { this->mergeDistance = mergeDistance; } // Set before inserting, points are merged only with stored points on their insertion path
+    };
+
+    typedef ConcurrentOrthtree<2> ConcurrentQuadtree;
+    typedef ConcurrentOrthtree<3> ConcurrentOctree;
+
+} // namespace sim
+
+#include "ConcurrentOrthtree_impl.tpp"
+
+#endif // CONCURRENTORTHTREE_HPP
@@ -0,0 +1,303 @@
+namespace sim
+{
+    template <int D>
+    ConcurrentOrthtree<D>::ConcurrentOrthtree(BoxType boundary, int capacity) : globalEpoch(1), readers(nullptr), version(0), capacity(capacity), maxDepth(DEFAULT_MAX_DEPTH), mergeDistance(0)
+    {
+        root.store(new Node(boundary, 0, version));
+    }
+
+    template <int D>
+    ConcurrentOrthtree<D>::~ConcurrentOrthtree()
+    {
+        deleteTree(root.load());
+        // Retired nodes are not part of the live tree and their children are shared, free them one by one
+        for (RetiredBatch& batch : retired)
+        {
+            for (const Node* node : batch.nodes)
+            {
+                delete node;
+            }
+        }
+        ReaderRecord* record = readers.load();
+        while (record != nullptr)
+        {
+            ReaderRecord* next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    template <int D>
+    void ConcurrentOrthtree<D>::deleteTree(const Node* node)
+    {
+        if (node == nullptr)
+        {
+            return;
+        }
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            deleteTree(node->children[i]);
+        }
+        delete node;
+    }
+
+    // --- Writers ---
+    template <int D>
+    bool ConcurrentOrthtree<D>::insert(PointType pt)
+    {
+        QT_STATS_COUNT(INSERT_CALLS);
+        std::lock_guard<std::mutex> lock(writerMutex);
+        const Node* current = root.load();
+        if (!current->boundary.contains(pt))
+        {
+            return false;
+        }
+        version++;
+        publish(insert(current, pt));
+        return true;
+    }
+
+    template <int D>
+    int ConcurrentOrthtree<D>::bulkInsert(std::vector<PointType> points)
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        version++;
+        const Node* current = root.load();
+        const Node* newRoot = current;
+        int inserted = 0;
+        for (const PointType& pt : points)
+        {
+            QT_STATS_COUNT(INSERT_CALLS);
+            // Ignore objects that do not belong in this tree
+            if (current->boundary.contains(pt))
+            {
+                newRoot = insert(newRoot, pt);
+                inserted++;
+            }
+        }
+        if (newRoot != current)
+        {
+            publish(newRoot);
+        }
+        return inserted;
+    }
+
+    // Nodes of the batch being written are not reachable by readers yet, so they can be modified in place
+    template <int D>
+    typename ConcurrentOrthtree<D>::Node* ConcurrentOrthtree<D>::writable(const Node* node)
+    {
+        if (node->version == version)
+        {
+            return const_cast<Node*>(node);
+        }
+        Node* copy = new Node(*node);
+        copy->version = version;
+        replaced.push_back(node);
+        return copy;
+    }
+
+    // Same steps as Orthtree::insert, but every node on the path is replaced by a writable copy
+    template <int D>
+    typename ConcurrentOrthtree<D>::Node* ConcurrentOrthtree<D>::insert(const Node* node, PointType pt)
+    {
+        Node* current = writable(node);
+
+        // Merge with a coincident point stored at this level, if any
+        int merged = OrthtreeSpace<D>::mergeIndex(current->points, pt, mergeDistance);
+        if (merged >= 0)
+        {
+            current->multiplicities[merged]++;
+            return current;
+        }
+
+        // If is not crowded (or max depth reached), add the point here
+        QT_STATS_COUNT(IS_CROWDED_EVALUATIONS);
+        if (OrthtreeSpace<D>::storesPoint(current->points.size() >= capacity, current->divided, current->depth, maxDepth))
+        {
+            QT_STATS_COUNT(INSERTED_POINTS);
+            current->points.push_back(pt);
+            current->multiplicities.push_back(1);
+            return current;
+        }
+
+        // Otherwise, subdivide and then add the point to the child that owns it
+        if (!current->divided)
+        {
+            subdivide(current);
+        }
+        int index = OrthtreeSpace<D>::childIndex(current->boundary, pt);
+        current->children[index] = insert(current->children[index], pt);
+        return current;
+    }
+
+    template <int D>
+    void ConcurrentOrthtree<D>::subdivide(Node* node)
+    {
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            node->children[i] = new Node(OrthtreeSpace<D>::childBox(node->boundary, i), node->depth + 1, version);
+        }
+        node->divided = true;
+        QT_STATS_COUNT(SUBDIVISIONS);
+    }
+
+    // Publish the new root, then advance the epoch: readers pinned at or before the old epoch may still see the replaced nodes
+    template <int D>
+    void ConcurrentOrthtree<D>::publish(const Node* newRoot)
+    {
+        root.store(newRoot, std::memory_order_seq_cst);
+        uint64_t retireEpoch = globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+        if (!replaced.empty())
+        {
+            retired.push_back(RetiredBatch{ retireEpoch, std::move(replaced) });
+            replaced.clear();
+        }
+        reclaim();
+    }
+
+    template <int D>
+    void ConcurrentOrthtree<D>::reclaim()
+    {
+        // Oldest epoch still pinned by a reader
+        uint64_t minEpoch = UINT64_MAX;
+        for (ReaderRecord* record = readers.load(std::memory_order_seq_cst); record != nullptr; record = record->next)
+        {
+            uint64_t epoch = record->epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < minEpoch)
+            {
+                minEpoch = epoch;
+            }
+        }
+        // Free the batches retired before it, batches are in epoch order
+        size_t freed = 0;
+        while (freed < retired.size() && retired[freed].retireEpoch < minEpoch)
+        {
+            for (const Node* node : retired[freed].nodes)
+            {
+                delete node;
+            }
+            freed++;
+        }
+        retired.erase(retired.begin(), retired.begin() + freed);
+    }
+
+    // --- Readers ---
+    // Claim a free record (or push a new one, lock-free) and pin the current epoch
+    template <int D>
+    typename ConcurrentOrthtree<D>::ReaderRecord* ConcurrentOrthtree<D>::pin() const
+    {
+        ReaderRecord* record = readers.load(std::memory_order_acquire);
+        for (; record != nullptr; record = record->next)
+        {
+            bool expected = false;
+            if (!record->inUse.load(std::memory_order_relaxed) && record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                break;
+            }
+        }
+        if (record == nullptr)
+        {
+            record = new ReaderRecord();
+            // seq_cst (with the load in reclaim) orders the push with the epoch accesses, so a writer that advanced the epoch sees the new record
+            ReaderRecord* head = readers.load(std::memory_order_relaxed);
+            do
+            {
+                record->next = head;
+            } while (!readers.compare_exchange_weak(head, record, std::memory_order_seq_cst, std::memory_order_relaxed));
+        }
+        // Re-check so the pinned epoch is the one the root will be read in
+        uint64_t epoch;
+        do
+        {
+            epoch = globalEpoch.load(std::memory_order_seq_cst);
+            record->epoch.store(epoch, std::memory_order_seq_cst);
+        } while (epoch != globalEpoch.load(std::memory_order_seq_cst));
+        return record;
+    }
+
+    template <int D>
+    typename ConcurrentOrthtree<D>::Snapshot ConcurrentOrthtree<D>::snapshot() const
+    {
+        ReaderRecord* record = pin();
+        return Snapshot(record, root.load(std::memory_order_seq_cst));
+    }
+
+    template <int D>
+    std::vector<typename ConcurrentOrthtree<D>::PointType> ConcurrentOrthtree<D>::queryRange(BoxType region) const
+    {
+        Snapshot pinned = snapshot();
+        std::vector<PointType> pointsInRange;
+        for (const PointType* pt : pinned.queryRange(region))
+        {
+            pointsInRange.push_back(*pt);
+        }
+        return pointsInRange;
+    }
+
+    template <int D>
+    ConcurrentOrthtree<D>::Snapshot::~Snapshot()
+    {
+        if (record != nullptr)
+        {
+            record->epoch.store(0, std::memory_order_release);
+            record->inUse.store(false, std::memory_order_release);
+        }
+    }
+
+    // Search for all points in range of a boundary
+    template <int D>
+    std::vector<const typename ConcurrentOrthtree<D>::PointType*> ConcurrentOrthtree<D>::Snapshot::queryRange(BoxType region) const
+    {
+        QT_STATS_COUNT(RANGE_QUERIES);
+        std::vector<const PointType*> pointsInRange;
+        std::vector<const Node*> toVisit;
+        toVisit.push_back(root);
+        while (!toVisit.empty())
+        {
+            const Node* node = toVisit.back();
+            toVisit.pop_back();
+            QT_STATS_COUNT(QUERY_NODES_VISITED);
+            if (!node->boundary.intersects(region))
+            {
+                continue;
+            }
+            for (const PointType& pt : node->points)
+            {
+                if (region.contains(pt))
+                {
+                    pointsInRange.push_back(&pt);
+                }
+            }
+            if (node->divided)
+            {
+                for (int i = CHILDREN - 1; i >= 0; i--)
+                {
+                    toVisit.push_back(node->children[i]);
+                }
+            }
+        }
+        return pointsInRange;
+    }
+
+    // Create list of leaf nodes
+    template <int D>
+    void ConcurrentOrthtree<D>::Snapshot::getLeafs(std::vector<const Node*>* leafs) const
+    {
+        std::vector<const Node*> toVisit;
+        toVisit.push_back(root);
+        while (!toVisit.empty())
+        {
+            const Node* node = toVisit.back();
+            toVisit.pop_back();
+            if (!node->divided)
+            {
+                leafs->push_back(node);
+                continue;
+            }
+            for (int i = CHILDREN - 1; i >= 0; i--)
+            {
+                toVisit.push_back(node->children[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*Immutable, cache friendly copy of a built Quadtree*/
+
+/*A FrozenQuadtree is produced by Quadtree::freeze() once a tree is fully built (inserted and balanced).
+* All nodes are stored in a single array in van Emde Boas order, where the atoms of the layout are sibling groups
+* (the four children of a node are always contiguous, so a node only needs the 32-bit offset of its first child).
+* Points are copied in the same order into a single array and every node owns an inline [begin, begin + count) range of it.
+* Nodes are addressed by their 32-bit index in the array; the root is always index 0 and NO_NODE marks a missing node.
+*/
+
+#ifndef FROZENQUADTREE_HPP
+#define FROZENQUADTREE_HPP
+
+#include <vector>
+#include <span>
+#include <cstdint>
+#include "Types.hpp"
+#include "Quadtree.hpp"
+
+namespace sim
+{
+    typedef struct FrozenNode
+    {
+        BoundingBox boundary;
+        uint32_t firstChild; // Index of the northWest child, children follow in NORTHWEST..SOUTHEAST order (NO_NODE if leaf)
+        uint32_t parent; // Index of the parent (NO_NODE for the root)
+        uint32_t pointsBegin; // First point of this node in the points array
+        uint32_t pointsCount; // Number of points stored in this node
+        int32_t depth;
+        uint8_t type; // Same values as Quadtree::type (ROOT, NORTHWEST, ...)
+
+        FrozenNode(BoundingBox boundary) : boundary(boundary), firstChild(0), parent(0), pointsBegin(0), pointsCount(0), depth(0), type(ROOT) {}
+    } FrozenNode;
+
+    template <typename uT, typename cT>
+    class FrozenQuadtree
+    {
+    private:
+        std::vector<FrozenNode> nodes;
+        std::vector<Point> points;
+        std::vector<int> multiplicities; // Same order as points
+
+        // Private methods
+        void layoutVEB(const Quadtree<uT, cT>* owner, int height, std::vector<const Quadtree<uT, cT>*>* order, std::vector<const Quadtree<uT, cT>*>* frontier); // Lay out the sibling groups of a subtree (truncated to height levels) in van Emde Boas order
+        uint32_t getNeighbour(uint32_t node, int axis, bool positive) const; // Face neighbour (axis 0 = x, 1 = y), without allocating
+
+    public:
+        static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+        FrozenQuadtree(const Quadtree<uT, cT>& qt); // Build the frozen copy of qt, used by Quadtree::freeze()
+
+        // Main methods
+        std::vector<const Point*> queryRange(BoundingBox range) const; // Get all points inside a range
+        void queryRange(BoundingBox range, std::vector<const Point*>* pointsInRange) const; // Same as above but appends to a vector provided by the caller
+        void getLeafs(std::vector<uint32_t>* leafs) const; // Get all leafs of the quadtree (as node indices), provide a vector to store them
+
+        // Getters
+        uint32_t getRoot() const { return 0; }
+        size_t size() const { return nodes.size(); } // Number of nodes
+        const FrozenNode& getNode(uint32_t node) const { return nodes[node]; }
+        BoundingBox getBoundary(uint32_t node) const { return nodes[node].boundary; }
+        std::span<const Point> getPoints(uint32_t node) const { return std::span<const Point>(points.data() + nodes[node].pointsBegin, nodes[node].pointsCount); }
+        std::span<const int> getMultiplicities(uint32_t node) const { return std::span<const int>(multiplicities.data() + nodes[node].pointsBegin, nodes[node].pointsCount); }
+        int getMultiplicity(const Point* point) const { return multiplicities[point - points.data()]; } // point must come from this tree (e.g. queryRange)
+        uint32_t getChild(uint32_t node, int type) const { return nodes[node].firstChild == NO_NODE ? NO_NODE : nodes[node].firstChild + (type - NORTHWEST); } // type is one of NORTHWEST..SOUTHEAST
+        uint32_t getParent(uint32_t node) const { return nodes[node].parent; }
+        bool isDivided(uint32_t node) const { return nodes[node].firstChild != NO_NODE; }
+        int getDepth(uint32_t node) const { return nodes[node].depth; }
+        int getType(uint32_t node) const { return nodes[node].type; }
+        // Get neighbours (same semantics as the Quadtree ones, NO_NODE if there is no neighbour)
+        uint32_t getNorthNeighbour(uint32_t node) const;
+        uint32_t getSouthNeighbour(uint32_t node) const;
+        uint32_t getEastNeighbour(uint32_t node) const;
+        uint32_t getWestNeighbour(uint32_t node) const;
+    };
+
+} // namespace sim
+
+#include "FrozenQuadtree_impl.tpp"
+
+#endif // FROZENQUADTREE_HPP
@@ -0,0 +1,224 @@
+#include <unordered_map>
+#include <stdexcept>
+
+namespace sim
+{
+    // Neighbour tables, indexed by node type (ROOT, NORTHWEST, NORTHEAST, SOUTHWEST, SOUTHEAST)
+    // sibling: the sibling that is the direct neighbour in that direction (0 if we have to go up to the parent)
+    // mirror: the child to take when tracing back down (N <-> S or E <-> W)
+    // Build the frozen copy of a Quadtree
+    template <typename uT, typename cT>
+    FrozenQuadtree<uT, cT>::FrozenQuadtree(const Quadtree<uT, cT>& qt)
+    {
+        // Find the height of the tree and count nodes and points
+        int maxDepth = 0;
+        size_t nodeCount = 0;
+        size_t pointCount = 0;
+        std::stack<const Quadtree<uT, cT>*> toVisit;
+        toVisit.push(&qt);
+        while (!toVisit.empty())
+        {
+            const Quadtree<uT, cT>* node = toVisit.top();
+            toVisit.pop();
+            nodeCount++;
+            pointCount += node->points.size();
+            if (node->depth - qt.depth > maxDepth) { maxDepth = node->depth - qt.depth; }
+            if (node->divided)
+            {
+                for (int i = 3; i >= 0; i--)
+                {
+                    toVisit.push(node->children[i]);
+                }
+            }
+        }
+        if (nodeCount >= NO_NODE || pointCount >= NO_NODE)
+        {
+            throw std::runtime_error("Quadtree too large to be frozen");
+        }
+
+        // Order the sibling groups (identified by their parent) in van Emde Boas order, the root goes first on its own
+        std::vector<const Quadtree<uT, cT>*> order;
+        if (qt.divided)
+        {
+            std::vector<const Quadtree<uT, cT>*> frontier;
+            layoutVEB(&qt, maxDepth, &order, &frontier);
+        }
+
+        // Assign an index to every node
+        std::unordered_map<const Quadtree<uT, cT>*, uint32_t> index;
+        index.reserve(nodeCount);
+        std::vector<const Quadtree<uT, cT>*> byIndex;
+        byIndex.reserve(nodeCount);
+        index[&qt] = 0;
+        byIndex.push_back(&qt);
+        for (const Quadtree<uT, cT>* owner : order)
+        {
+            for (const Quadtree<uT, cT>* child : owner->children)
+            {
+                index[child] = static_cast<uint32_t>(byIndex.size());
+                byIndex.push_back(child);
+            }
+        }
+
+        // Copy nodes and points in layout order
+        nodes.reserve(nodeCount);
+        points.reserve(pointCount);
+        multiplicities.reserve(pointCount);
+        for (const Quadtree<uT, cT>* node : byIndex)
+        {
+            FrozenNode frozen(node->boundary);
+            frozen.firstChild = node->divided ? index[node->children[0]] : NO_NODE;
+            frozen.parent = node == &qt ? NO_NODE : index[node->parent];
+            frozen.pointsBegin = static_cast<uint32_t>(points.size());
+            frozen.pointsCount = static_cast<uint32_t>(node->points.size());
+            frozen.depth = node->depth - qt.depth;
+            frozen.type = node == &qt ? ROOT : node->type;
+            points.insert(points.end(), node->points.begin(), node->points.end());
+            multiplicities.insert(multiplicities.end(), node->multiplicities.begin(), node->multiplicities.end());
+            nodes.push_back(frozen);
+        }
+    }
+
+    // Recursive van Emde Boas layout: the top half of the (truncated) subtree goes first, then each bottom subtree
+    // Groups just below the truncated subtree are pushed to frontier, so the caller can lay them out next
+    template <typename uT, typename cT>
+    void FrozenQuadtree<uT, cT>::layoutVEB(const Quadtree<uT, cT>* owner, int height, std::vector<const Quadtree<uT, cT>*>* order, std::vector<const Quadtree<uT, cT>*>* frontier)
+    {
+        if (height == 1)
+        {
+            order->push_back(owner);
+            for (const Quadtree<uT, cT>* child : owner->children)
+            {
+                if (child->divided) { frontier->push_back(child); }
+            }
+            return;
+        }
+        int topHeight = height / 2;
+        std::vector<const Quadtree<uT, cT>*> middle;
+        layoutVEB(owner, topHeight, order, &middle);
+        for (const Quadtree<uT, cT>* subtree : middle)
+        {
+            layoutVEB(subtree, height - topHeight, order, frontier);
+        }
+    }
+
+    // Search for all points in range of a boundary
+    template <typename uT, typename cT>
+    std::vector<const Point*> FrozenQuadtree<uT, cT>::queryRange(BoundingBox region) const
+    {
+        QT_STATS_COUNT(RANGE_QUERIES);
+        std::vector<const Point*> pointsInRange;
+        queryRange(region, &pointsInRange);
+        return pointsInRange;
+    }
+
+    template <typename uT, typename cT>
+    void FrozenQuadtree<uT, cT>::queryRange(BoundingBox region, std::vector<const Point*>* pointsInRange) const
+    {
+        // Iterative traversal, children are contiguous so they are pushed as a block
+        std::vector<uint32_t> toVisit;
+        toVisit.push_back(0);
+        while (!toVisit.empty())
+        {
+            const FrozenNode& node = nodes[toVisit.back()];
+            toVisit.pop_back();
+            QT_STATS_COUNT(QUERY_NODES_VISITED);
+            if (!node.boundary.intersects(region))
+            {
+                continue;
+            }
+            const Point* first = points.data() + node.pointsBegin;
+            for (uint32_t i = 0; i < node.pointsCount; i++)
+            {
+                if (region.contains(first[i]))
+                {
+                    pointsInRange->push_back(&first[i]);
+                }
+            }
+            if (node.firstChild != NO_NODE)
+            {
+                // Push in reverse so children are visited in NORTHWEST..SOUTHEAST order (same as Quadtree::queryRange)
+                toVisit.push_back(node.firstChild + 3);
+                toVisit.push_back(node.firstChild + 2);
+                toVisit.push_back(node.firstChild + 1);
+                toVisit.push_back(node.firstChild);
+            }
+        }
+    }
+
+    // Create list of leaf nodes (same order as Quadtree::getLeafs)
+    template <typename uT, typename cT>
+    void FrozenQuadtree<uT, cT>::getLeafs(std::vector<uint32_t>* leafs) const
+    {
+        std::vector<uint32_t> toVisit;
+        toVisit.push_back(0);
+        while (!toVisit.empty())
+        {
+            uint32_t node = toVisit.back();
+            toVisit.pop_back();
+            uint32_t firstChild = nodes[node].firstChild;
+            if (firstChild != NO_NODE)
+            {
+                toVisit.push_back(firstChild + 3);
+                toVisit.push_back(firstChild + 2);
+                toVisit.push_back(firstChild + 1);
+                toVisit.push_back(firstChild);
+            }
+            else
+            {
+                leafs->push_back(node);
+            }
+        }
+    }
+
+    // Same algorithm as Orthtree::getNeighbour: go up until the node is on the other side of the axis than the requested direction,
+    // take the sibling across it, then go down on the side facing the node, following the node's position on the other axes
+    template <typename uT, typename cT>
+    uint32_t FrozenQuadtree<uT, cT>::getNeighbour(uint32_t node, int axis, bool positive) const
+    {
+        int axisBit = 1 << axis;
+        const BoundingBox& box = nodes[node].boundary;
+        Point center((box.topLeft.x + box.bottomRight.x) / 2, (box.topLeft.y + box.bottomRight.y) / 2);
+        int depth = nodes[node].depth;
+        uint32_t current = node;
+        while (nodes[current].type != ROOT)
+        {
+            int index = nodes[current].type - NORTHWEST;
+            uint32_t parent = nodes[current].parent;
+            if (((index & axisBit) != 0) != positive)
+            {
+                current = nodes[parent].firstChild + (index ^ axisBit);
+                while (nodes[current].firstChild != NO_NODE && nodes[current].depth < depth)
+                {
+                    int childIndex = OrthtreeSpace<2>::childIndex(nodes[current].boundary, center);
+                    childIndex = positive ? (childIndex & ~axisBit) : (childIndex | axisBit);
+                    current = nodes[current].firstChild + childIndex;
+                }
+                return current;
+            }
+            current = parent;
+        }
+        return NO_NODE;
+    }
+
+    template <typename uT, typename cT>
+    uint32_t FrozenQuadtree<uT, cT>::getNorthNeighbour(uint32_t node) const
+    {
+        return getNeighbour(node, 1, false);
+    }
+    template <typename uT, typename cT>
+    uint32_t FrozenQuadtree<uT, cT>::getSouthNeighbour(uint32_t node) const
+    {
+        return getNeighbour(node, 1, true);
+    }
+    template <typename uT, typename cT>
+    uint32_t FrozenQuadtree<uT, cT>::getEastNeighbour(uint32_t node) const
+    {
+        return getNeighbour(node, 0, true);
+    }
+    template <typename uT, typename cT>
+    uint32_t FrozenQuadtree<uT, cT>::getWestNeighbour(uint32_t node) const
+    {
+        return getNeighbour(node, 0, false);
+    }
+}
@@ -29,29 +29,7 @@ namespace sim
             {
 				// If there is a point, add it to the correct child
                 Point point = qt->getPoints()[0];
-                if (qt->getNorthWest()->getBoundary().contains(point))
-                {
-					qt->getNorthWest()->forceInsert(point);
-				}
-                else if (qt->getNorthEast()->getBoundary().contains(point))
-                {
-					qt->getNorthEast()->forceInsert(point);
-				}
-                else if (qt->getSouthWest()->getBoundary().contains(point))
-                {
-					qt->getSouthWest()->forceInsert(point);
-				}
-                else if (qt->getSouthEast()->getBoundary().contains(point))
-                {
-					qt->getSouthEast()->forceInsert(point);
-				}
-                else
-                {
-                    // Should never happen
-					std::cout << "Error: point not in boundary" << std::endl;
-                    exit(1);
-				}
-				
+                qt->getChild(qt->getQuadrant(point))->forceInsert(point);
 			}
 			// Recursively go down the quadtree
 			projectQuadtree(qt->getNorthWest(), qt_projection);
@@ -0,0 +1,222 @@
+/*Dimension templated tree (quadtree in 2D, octree in 3D), see Quadtree.hpp for the aliases*/
+
+/*Children of a node are indexed by bits: bit a is set when the child is on the upper side of axis a.
+* A node's type is its child index + 1 (0 = root), so in 2D types are NORTHWEST, NORTHEAST, SOUTHWEST, SOUTHEAST.
+* The dimension is a compile time constant, so all the per-axis and per-child loops unroll.
+*/
+
+#ifndef ORTHTREE_HPP
+#define ORTHTREE_HPP
+
+#define ROOT 0
+
+#define DEFAULT_MAX_DEPTH 32 // Nodes at this depth never subdivide, extra points are kept in the node (overflow bucket)
+
+#include <vector>
+#include <array>
+#include <functional>
+#include <queue>
+#include <stack>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include "Types.hpp"
+#include "Stats.hpp"
+
+namespace sim
+{
+    // Point and box types of each dimension, plus coordinate access by axis
+    template <int D> struct OrthtreeSpace;
+
+    // Node geometry and storage rules shared by every tree of dimension D (Orthtree, ConcurrentOrthtree)
+    template <int D, typename Space>
+    struct OrthtreeRules
+    {
+        // Child owning a point: bit a is set when it is on the upper side of axis a, children are half-open on their upper sides
+        static int childIndex(const auto& box, const auto& pt)
+        {
+            int index = 0;
+            for (int axis = 0; axis < D; axis++)
+            {
+                double mid = (Space::coord(Space::lower(box), axis) + Space::coord(Space::upper(box), axis)) / 2;
+                if (Space::coord(pt, axis) >= mid)
+                {
+                    index |= 1 << axis;
+                }
+            }
+            return index;
+        }
+
+        // Box of a child (same indexing as childIndex)
+        static auto childBox(const auto& box, int index)
+        {
+            std::array<double, D> childLower, childUpper;
+            for (int axis = 0; axis < D; axis++)
+            {
+                double lower = Space::coord(Space::lower(box), axis);
+                double upper = Space::coord(Space::upper(box), axis);
+                double mid = (lower + upper) / 2;
+                bool upperSide = index & (1 << axis);
+                childLower[axis] = upperSide ? mid : lower;
+                childUpper[axis] = upperSide ? upper : mid;
+            }
+            return Space::makeBox(childLower, childUpper);
+        }
+
+        // Stored point a new point merges with (closer than mergeDistance), -1 if none
+        static int mergeIndex(auto& points, const auto& pt, double mergeDistance)
+        {
+            double mergeSquareDistance = mergeDistance * mergeDistance;
+            for (int i = 0; i < points.size(); i++)
+            {
+                if (points[i].squareDistance(pt) <= mergeSquareDistance)
+                {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        // A point is stored in the node when it is not crowded, or when it is a leaf at max depth (overflow bucket, so build cost stays bounded)
+        static bool storesPoint(bool crowded, bool divided, int depth, int maxDepth)
+        {
+            return !crowded || (!divided && depth >= maxDepth);
+        }
+    };
+
+    template <> struct OrthtreeSpace<2> : OrthtreeRules<2, OrthtreeSpace<2>>
+    {
+        typedef Point PointType;
+        typedef BoundingBox BoxType;
+        static double coord(const Point& pt, int axis) { return axis == 0 ? pt.x : pt.y; }
+        static Point lower(const BoundingBox& box) { return box.topLeft; }
+        static Point upper(const BoundingBox& box) { return box.bottomRight; }
+        static Point makePoint(const std::array<double, 2>& c) { return Point(c[0], c[1]); }
+        static BoundingBox makeBox(const std::array<double, 2>& lo, const std::array<double, 2>& hi) { return BoundingBox(makePoint(lo), makePoint(hi)); }
+    };
+
+    template <> struct OrthtreeSpace<3> : OrthtreeRules<3, OrthtreeSpace<3>>
+    {
+        typedef Point3 PointType;
+        typedef BoundingBox3 BoxType;
+        static double coord(const Point3& pt, int axis) { return axis == 0 ? pt.x : (axis == 1 ? pt.y : pt.z); }
+        static Point3 lower(const BoundingBox3& box) { return box.minCorner; }
+        static Point3 upper(const BoundingBox3& box) { return box.maxCorner; }
+        static Point3 makePoint(const std::array<double, 3>& c) { return Point3(c[0], c[1], c[2]); }
+        static BoundingBox3 makeBox(const std::array<double, 3>& lo, const std::array<double, 3>& hi) { return BoundingBox3(makePoint(lo), makePoint(hi)); }
+    };
+
+    template <typename uT, typename cT> class FrozenQuadtree;
+    template <int D, typename uT, typename cT> class AdaptiveRefiner;
+
+    template <int D, typename uT, typename cT> // D is the dimension, uT is userData type while cT is the type of isCrowded function
+    class Orthtree
+    {
+    public:
+        typedef typename OrthtreeSpace<D>::PointType PointType;
+        typedef typename OrthtreeSpace<D>::BoxType BoxType;
+        static constexpr int CHILDREN = 1 << D;
+
+    private:
+        friend class FrozenQuadtree<uT, cT>;
+        template <int, typename, typename> friend class Orthtree; // Spatial join between trees with different user data
+        friend class AdaptiveRefiner<D, uT, cT>;
+
+        BoxType boundary;
+        int capacity;
+        int depth;
+        std::vector<PointType> points;
+        std::vector<int> multiplicities; // multiplicities[i] = number of coincident points merged into points[i]
+        int maxDepth;
+        double mergeDistance; // Points closer than this to any stored point of the tree are merged with it (0 = only identical points)
+        Orthtree *children[CHILDREN];
+        Orthtree *parent;
+        int type; // 0 = root, otherwise child index + 1
+        bool divided;
+        std::function<bool(Orthtree *, cT)> isCrowded;
+        cT isCrowdedData;
+        uT userData;
+
+        // Private methods
+        bool insertPoint(PointType point); // Recursive helper for insert (merges only with the points on the insertion path)
+        bool mergeNearby(PointType point); // Merge with the closest stored point of the whole tree within mergeDistance, if any
+        void queryRange(BoxType range, std::vector<PointType*>* pointsInRange); // Recursive helper for queryRange
+        void bulkInsert(std::vector<PointType>* batch); // Recursive helper for bulkInsert
+        // Recursive helpers for spatialJoin and selfJoin
+        static double boxSquareDistance(const BoxType& a, const BoxType& b); // 0 if the boxes intersect
+        template <typename oT, typename ocT, typename Callback>
+        void joinNodes(Orthtree<D, oT, ocT>* other, double squareDistance, Callback& callback); // Pairs subtree(this) x subtree(other)
+        template <typename oT, typename ocT, typename Callback>
+        void joinNodeLevel(Orthtree<D, oT, ocT>* other, double squareDistance, Callback& callback); // Same, except the pairs between the children of both nodes
+        template <bool ownOnB, typename oT, typename ocT, typename Callback>
+        void joinOwnPoints(Orthtree<D, oT, ocT>* other, double squareDistance, Callback& callback); // Pairs points stored here x subtree(other), ownOnB tells on which side of the callback the stored points go
+        template <typename Callback>
+        void selfJoinNodes(double squareDistance, Callback& callback); // Unordered pairs within subtree(this)
+        template <typename Callback>
+        void selfJoinNodeLevel(double squareDistance, Callback& callback); // Same, except the pairs within and between the children
+
+    public:
+        Orthtree(BoxType boundary, int capacity); // Constructor that uses simple isCrowded function (see utility.hpp)
+        Orthtree(BoxType boundary, int capacity, std::function<bool(Orthtree*, cT)> isCrowded, cT isCrowdedData);// Constructor that uses custom isCrowded function
+        Orthtree(BoxType boundary, int capacity, std::function<bool(Orthtree*, cT)> isCrowded, cT isCrowdedData, uT userData);// Constructor that uses custom isCrowded function and userData
+        Orthtree(BoxType boundary, int capacity, uT userData);// Constructor that uses custom userData
+        Orthtree(BoxType boundary, int capacity, std::function<bool(Orthtree *, cT)> isCrowded, cT isCrowdedData, uT userData, Orthtree* parent, int type); // Principal constructor
+        Orthtree(BoxType boundary, Orthtree* parent, int type); // Constructor used by subdivide function
+        ~Orthtree();
+
+        // Main methods
+        void subdivide();
+        void merge(); // Inverse of subdivide: remove the children (and their subtrees), their points are moved to this node
+        bool insert(PointType point);
+        int bulkInsert(std::vector<PointType> points); // Insert many points at once (same tree as inserting them in order for criteria depending only on the node), returns how many were inserted
+        std::vector<PointType*> queryRange(BoxType range); // Get all points inside a range
+        void balance();
+        void getLeafs(std::queue<Orthtree*>* leafsQueue); // Get all leafs of the tree, provide a queue to store them
+        template <typename oT, typename ocT, typename Callback>
+        void spatialJoin(Orthtree<D, oT, ocT>& other, double distance, Callback callback, int threads = 1); // Call callback(PointType* a, PointType* b) for each pair (a in this, b in other) closer than distance (callback must be thread safe if threads > 1)
+        template <typename Callback>
+        void selfJoin(double distance, Callback callback, int threads = 1); // Call callback(PointType* a, PointType* b) once for each pair of distinct stored points closer than distance
+        TreeStats getTreeStats() const; // Get statistics (depth, leaf occupancy, memory) of the tree rooted at this node
+        FrozenQuadtree<uT, cT> freeze() const requires (D == 2); // Get an immutable, cache friendly copy of the quadtree (see FrozenQuadtree.hpp)
+
+        // Special methods
+        void forceInsert(PointType point); // Insert a point even if the node is crowded
+        int getQuadrant(PointType point) const; // Type of the child owning a point (octant in 3D), children are half-open so each point belongs to exactly one
+
+        // Getters and setters
+        BoxType getBoundary() const { return boundary; }
+        std::vector<PointType> getPoints() const { return points; }
+        std::vector<int> getMultiplicities() const { return multiplicities; } // Same order as getPoints()
+        int getMultiplicity(const PointType* point) const; // point must come from this (sub)tree (e.g. queryRange, spatialJoin), 0 otherwise
+        int getCapacity() const { return capacity; }
+        int getMaxDepth() const { return maxDepth; }
+        double getMergeDistance() const { return mergeDistance; }
+        void setMaxDepth(int maxDepth) { this->maxDepth = maxDepth; } // Set on the root before inserting, children inherit it
+        void setMergeDistance(double mergeDistance) { this->mergeDistance = mergeDistance; } // Set on the root before inserting, children inherit it
+        Orthtree *getNorthWest() const requires (D == 2) { return children[0]; }
+        Orthtree *getNorthEast() const requires (D == 2) { return children[1]; }
+        Orthtree *getSouthWest() const requires (D == 2) { return children[2]; }
+        Orthtree *getSouthEast() const requires (D == 2) { return children[3]; }
+        Orthtree *getChild(int type) const { return (type > ROOT && type <= CHILDREN) ? children[type - 1] : nullptr; } // type is child index + 1 (NORTHWEST..SOUTHEAST in 2D)
+        Orthtree *getParent() const { return parent; }
+        uT *getUserData() const { return userData; }
+        std::function<bool(Orthtree *, cT)> getIsCrowdedFun() const { return isCrowded; }
+        void setUserData(uT userData) { this->userData = userData; }
+        bool isDivided() const { return divided; }
+        int getDepth() const { return depth; }
+        int getType() const { return type; }
+        // Get neighbours: face neighbour along an axis, on the upper (positive) or lower side
+        Orthtree* getNeighbour(int axis, bool positive);
+        Orthtree* getNorthNeighbour() requires (D == 2) { return getNeighbour(1, false); }
+        Orthtree* getSouthNeighbour() requires (D == 2) { return getNeighbour(1, true); }
+        Orthtree* getEastNeighbour() requires (D == 2) { return getNeighbour(0, true); }
+        Orthtree* getWestNeighbour() requires (D == 2) { return getNeighbour(0, false); }
+        std::vector<Orthtree*> getExtendedNeighbours(); // Neighbours in all the 3^D - 1 directions (diagonals included), same or bigger size than the node, each listed once
+
+    };
+
+} // namespace sim
+
+#include "Orthtree_impl.tpp"
+
+#endif // ORTHTREE_HPP
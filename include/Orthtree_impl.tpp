@@ -0,0 +1,879 @@
+namespace sim
+{
+    // Principal constructor
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::Orthtree(BoxType boundary, int capacity, std::function<bool(Orthtree<D, uT, cT>*, cT)> isCrowded, cT isCrowdedData, uT userData, Orthtree<D, uT, cT>* parent, int type) : boundary(boundary), capacity(capacity), divided(false), isCrowded(isCrowded), isCrowdedData(isCrowdedData), userData(userData), parent(parent), type(type)
+    {
+        points.reserve(capacity); // Reserve memory for the points vector
+        multiplicities.reserve(capacity);
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            children[i] = nullptr;
+        }
+        // Set the depth of the tree and inherit the limits from the parent
+        if (parent != nullptr)
+        {
+            depth = parent->depth + 1;
+            maxDepth = parent->maxDepth;
+            mergeDistance = parent->mergeDistance;
+        }
+        else
+        {
+            depth = 0;
+            maxDepth = DEFAULT_MAX_DEPTH;
+            mergeDistance = 0;
+        }
+    }
+
+    // Constructor with default isCrowded function
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::Orthtree(BoxType boundary, int capacity)
+        : Orthtree(
+            boundary,
+            capacity,
+            [](Orthtree<D, uT, cT>* tree, cT data) { return tree->points.size() >= tree->capacity; },
+            cT(),
+            uT(),
+            nullptr,
+            0)
+    {
+        // Delegate to the principal constructor
+    }
+
+    // Constructor with custom isCrowded function
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::Orthtree(BoxType boundary, int capacity, std::function<bool(Orthtree<D, uT, cT>*, cT)> isCrowded, cT isCrowdedData)
+        : Orthtree(
+            boundary,
+            capacity,
+            isCrowded,
+            isCrowdedData,
+            uT(),
+            nullptr,
+            0)
+    {
+        // Delegate to the principal constructor
+    }
+
+    // Constructor with custom isCrowded function and user data
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::Orthtree(BoxType boundary, int capacity, std::function<bool(Orthtree*, cT)> isCrowded, cT isCrowdedData, uT userData)
+        : Orthtree(
+            boundary,
+            capacity,
+            isCrowded,
+            isCrowdedData,
+            userData,
+            nullptr,
+            0)
+    {
+        // Delegate to the principal constructor
+    }
+
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::Orthtree(BoxType boundary, int capacity, uT userData)
+        : Orthtree(
+            boundary,
+            capacity,
+            [](Orthtree<D, uT, cT>* tree, cT data) { return tree->points.size() >= tree->capacity; },
+            cT(),
+            userData,
+            nullptr,
+            0)
+    {
+        // Delegate to the principal constructor
+    }
+
+    // Constructor with parent specified, used by subdivide function
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::Orthtree(BoxType boundary, Orthtree<D, uT, cT>* parent, int type)
+        : Orthtree(
+            boundary,
+            parent->getCapacity(),
+            parent->getIsCrowdedFun(),
+            cT(),
+            uT(),
+            parent,
+            type)
+    {
+        // Delegate to the "full" constructor
+    }
+
+    // Destructor
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>::~Orthtree()
+    {
+        points.clear(); // Clear the points vector
+        multiplicities.clear();
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            delete children[i];
+        }
+        //delete parent;
+    }
+
+    // Subdivide the node into 2^D smaller nodes
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::subdivide()
+    {
+        // Check if the node is already divided, if so, return (should never happen, but better safe than sorry)
+        if (divided)
+        {
+            return;
+        }
+        // Create the smaller nodes, child i is on the upper side of axis a when bit a of i is set
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            children[i] = new Orthtree(OrthtreeSpace<D>::childBox(boundary, i), this, i + 1);
+        }
+        QT_STATS_COUNT(SUBDIVISIONS);
+
+        // Set the divided flag to true
+        divided = true;
+    }
+
+    // Merge the subtree back into this node
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::merge()
+    {
+        if (!divided)
+        {
+            return;
+        }
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            children[i]->merge();
+            points.insert(points.end(), children[i]->points.begin(), children[i]->points.end());
+            multiplicities.insert(multiplicities.end(), children[i]->multiplicities.begin(), children[i]->multiplicities.end());
+            delete children[i];
+            children[i] = nullptr;
+        }
+        QT_STATS_COUNT(MERGES);
+
+        divided = false;
+    }
+
+    // Insert a point into the tree
+    template <int D, typename uT, typename cT>
+    bool Orthtree<D, uT, cT>::insert(PointType pt)
+    {
+        QT_STATS_COUNT(INSERT_CALLS);
+        // Ignore objects that do not belong in this tree
+        if (!boundary.contains(pt))
+        {
+            return false;
+        }
+
+        // Identical points always follow the same path, but close points can be on the other side of a split
+        if (mergeDistance > 0 && mergeNearby(pt))
+        {
+            return true;
+        }
+        return insertPoint(pt);
+    }
+
+    // Insert a point into the subtree (uses a recursive approach)
+    template <int D, typename uT, typename cT>
+    bool Orthtree<D, uT, cT>::insertPoint(PointType pt)
+    {
+        // Merge with a coincident point stored at this level, if any
+        int merged = OrthtreeSpace<D>::mergeIndex(points, pt, mergeDistance);
+        if (merged >= 0)
+        {
+            multiplicities[merged]++;
+            return true;
+        }
+
+        // If is not crowded (or max depth reached), add the point here
+        QT_STATS_COUNT(IS_CROWDED_EVALUATIONS);
+        if (OrthtreeSpace<D>::storesPoint(isCrowded(this, isCrowdedData), divided, depth, maxDepth))
+        {
+            QT_STATS_COUNT(INSERTED_POINTS);
+            points.push_back(pt);
+            multiplicities.push_back(1);
+            return true;
+        }
+
+        // Otherwise, subdivide and then add the point to the child that owns it
+        if (!divided)
+        {
+            subdivide();
+        }
+
+        return children[OrthtreeSpace<D>::childIndex(boundary, pt)]->insertPoint(pt);
+    }
+
+    // Radius search from the root: nodes farther than mergeDistance from the point are skipped
+    template <int D, typename uT, typename cT>
+    bool Orthtree<D, uT, cT>::mergeNearby(PointType pt)
+    {
+        Orthtree* root = this;
+        while (root->parent != nullptr)
+        {
+            root = root->parent;
+        }
+        std::array<double, D> c;
+        for (int axis = 0; axis < D; axis++)
+        {
+            c[axis] = OrthtreeSpace<D>::coord(pt, axis);
+        }
+        BoxType pointBox = OrthtreeSpace<D>::makeBox(c, c);
+
+        double mergeSquareDistance = mergeDistance * mergeDistance;
+        Orthtree* closestNode = nullptr;
+        int closestIndex = -1;
+        double closestSquareDistance = mergeSquareDistance;
+        std::stack<Orthtree*> toVisit;
+        toVisit.push(root);
+        while (!toVisit.empty())
+        {
+            Orthtree* node = toVisit.top();
+            toVisit.pop();
+            if (boxSquareDistance(node->boundary, pointBox) > closestSquareDistance)
+            {
+                continue;
+            }
+            for (int i = 0; i < node->points.size(); i++)
+            {
+                double squareDistance = node->points[i].squareDistance(pt);
+                if (squareDistance <= closestSquareDistance)
+                {
+                    closestNode = node;
+                    closestIndex = i;
+                    closestSquareDistance = squareDistance;
+                }
+            }
+            if (node->divided)
+            {
+                for (int i = 0; i < CHILDREN; i++)
+                {
+                    toVisit.push(node->children[i]);
+                }
+            }
+        }
+        if (closestNode == nullptr)
+        {
+            return false;
+        }
+        closestNode->multiplicities[closestIndex]++;
+        return true;
+    }
+
+    // Points are stored on the path of their coordinates (insert, forceInsert and merge keep them there), so search along it
+    template <int D, typename uT, typename cT>
+    int Orthtree<D, uT, cT>::getMultiplicity(const PointType* point) const
+    {
+        const Orthtree* node = this;
+        while (node != nullptr)
+        {
+            if (point >= node->points.data() && point < node->points.data() + node->points.size())
+            {
+                return node->multiplicities[point - node->points.data()];
+            }
+            node = node->divided ? node->getChild(node->getQuadrant(*point)) : nullptr;
+        }
+        return 0;
+    }
+
+    // Insert many points at once: each node processes its whole batch (in order) and hands the rest to its children in one go
+    template <int D, typename uT, typename cT>
+    int Orthtree<D, uT, cT>::bulkInsert(std::vector<PointType> batch)
+    {
+        // Ignore objects that do not belong in this tree
+        std::vector<PointType> inside;
+        inside.reserve(batch.size());
+        for (const PointType& pt : batch)
+        {
+            QT_STATS_COUNT(INSERT_CALLS);
+            if (boundary.contains(pt))
+            {
+                inside.push_back(pt);
+            }
+        }
+        int inserted = inside.size();
+        if (mergeDistance > 0)
+        {
+            // Merging needs a radius search over the whole tree for every point, including the points of the same batch
+            for (const PointType& pt : inside)
+            {
+                if (!mergeNearby(pt))
+                {
+                    insertPoint(pt);
+                }
+            }
+            return inserted;
+        }
+        bulkInsert(&inside);
+        return inserted;
+    }
+
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::bulkInsert(std::vector<PointType>* batch)
+    {
+        std::vector<PointType> childBatches[CHILDREN];
+        for (PointType& pt : *batch)
+        {
+            // Same steps as insert, but points going down are collected per child
+            int merged = OrthtreeSpace<D>::mergeIndex(points, pt, mergeDistance);
+            if (merged >= 0)
+            {
+                multiplicities[merged]++;
+                continue;
+            }
+            QT_STATS_COUNT(IS_CROWDED_EVALUATIONS);
+            if (OrthtreeSpace<D>::storesPoint(isCrowded(this, isCrowdedData), divided, depth, maxDepth))
+            {
+                QT_STATS_COUNT(INSERTED_POINTS);
+                points.push_back(pt);
+                multiplicities.push_back(1);
+                continue;
+            }
+            if (!divided)
+            {
+                subdivide();
+            }
+            childBatches[OrthtreeSpace<D>::childIndex(boundary, pt)].push_back(pt);
+        }
+        batch->clear();
+
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            if (!childBatches[i].empty())
+            {
+                children[i]->bulkInsert(&childBatches[i]);
+            }
+        }
+    }
+
+    // Child owning a point: children are half-open on their upper sides (the outer edges of the parent are closed)
+    template <int D, typename uT, typename cT>
+    int Orthtree<D, uT, cT>::getQuadrant(PointType pt) const
+    {
+        return OrthtreeSpace<D>::childIndex(boundary, pt) + 1;
+    }
+
+    // Insert a point in the tree even if it is crowded
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::forceInsert(PointType pt)
+    {
+        points.push_back(pt);
+        multiplicities.push_back(1);
+    }
+
+    // Create list of leaf nodes
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::getLeafs(std::queue<Orthtree*>* leafsQueue)
+    {
+        if (this->divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                this->children[i]->getLeafs(leafsQueue);
+            }
+        }
+        else
+        {
+            leafsQueue->push(this);
+        }
+    }
+
+    // Relay the quadtree into an immutable array (van Emde Boas order), use it once the tree will not be modified anymore
+    template <int D, typename uT, typename cT>
+    FrozenQuadtree<uT, cT> Orthtree<D, uT, cT>::freeze() const requires (D == 2)
+    {
+        return FrozenQuadtree<uT, cT>(*this);
+    }
+
+    // Search for all points in range of a boundary
+    template <int D, typename uT, typename cT>
+    std::vector<typename Orthtree<D, uT, cT>::PointType*> Orthtree<D, uT, cT>::queryRange(BoxType region)
+    {
+        QT_STATS_COUNT(RANGE_QUERIES);
+        // Create vector of points to return, filled by the recursive helper
+        std::vector<PointType*> pointsInRange;
+        queryRange(region, &pointsInRange);
+        return pointsInRange;
+    }
+
+    // Recursive helper for queryRange, appends to the provided vector instead of merging one vector per node
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::queryRange(BoxType region, std::vector<PointType*>* pointsInRange)
+    {
+        QT_STATS_COUNT(QUERY_NODES_VISITED);
+        // Check that region intersects with the node boundary
+        if (!boundary.intersects(region))
+        {
+            return;
+        }
+        // Add the points at this level
+        for (int i = 0; i < points.size(); i++)
+        {
+            if (region.contains(points[i]))
+            {
+                pointsInRange->push_back(&points[i]);
+            }
+        }
+        // Terminate here if the node is not divided
+        if (!divided)
+        {
+            return;
+        }
+        // Otherwise, add the points from the children
+        for (int i = 0; i < CHILDREN; i++)
+        {
+            children[i]->queryRange(region, pointsInRange);
+        }
+    }
+
+    // --- Spatial join ---
+    template <int D, typename uT, typename cT>
+    double Orthtree<D, uT, cT>::boxSquareDistance(const BoxType& a, const BoxType& b)
+    {
+        double squareDistance = 0;
+        for (int axis = 0; axis < D; axis++)
+        {
+            double gap = std::max(
+                OrthtreeSpace<D>::coord(OrthtreeSpace<D>::lower(b), axis) - OrthtreeSpace<D>::coord(OrthtreeSpace<D>::upper(a), axis),
+                OrthtreeSpace<D>::coord(OrthtreeSpace<D>::lower(a), axis) - OrthtreeSpace<D>::coord(OrthtreeSpace<D>::upper(b), axis));
+            if (gap > 0)
+            {
+                squareDistance += gap * gap;
+            }
+        }
+        return squareDistance;
+    }
+
+    // Dual-tree join: subtree(a) = points of a + subtrees of its children, so the pairs of (a, b) are
+    // a.points x b.points, a.points x subtree(b children), subtree(a children) x b.points and the children pairs
+    template <int D, typename uT, typename cT>
+    template <typename oT, typename ocT, typename Callback>
+    void Orthtree<D, uT, cT>::joinNodes(Orthtree<D, oT, ocT>* other, double squareDistance, Callback& callback)
+    {
+        QT_STATS_COUNT(JOIN_NODE_PAIRS);
+        // Prune node pairs that are too far apart
+        if (boxSquareDistance(boundary, other->boundary) > squareDistance)
+        {
+            return;
+        }
+        joinNodeLevel(other, squareDistance, callback);
+        if (divided && other->divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                for (int j = 0; j < CHILDREN; j++)
+                {
+                    children[i]->joinNodes(other->children[j], squareDistance, callback);
+                }
+            }
+        }
+    }
+
+    template <int D, typename uT, typename cT>
+    template <typename oT, typename ocT, typename Callback>
+    void Orthtree<D, uT, cT>::joinNodeLevel(Orthtree<D, oT, ocT>* other, double squareDistance, Callback& callback)
+    {
+        for (PointType& a : points)
+        {
+            for (PointType& b : other->points)
+            {
+                if (a.squareDistance(b) <= squareDistance)
+                {
+                    callback(&a, &b);
+                }
+            }
+        }
+        if (other->divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                joinOwnPoints<false>(other->children[i], squareDistance, callback);
+            }
+        }
+        if (divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                other->template joinOwnPoints<true>(children[i], squareDistance, callback);
+            }
+        }
+    }
+
+    template <int D, typename uT, typename cT>
+    template <bool ownOnB, typename oT, typename ocT, typename Callback>
+    void Orthtree<D, uT, cT>::joinOwnPoints(Orthtree<D, oT, ocT>* other, double squareDistance, Callback& callback)
+    {
+        if (points.empty())
+        {
+            return;
+        }
+        QT_STATS_COUNT(JOIN_NODE_PAIRS);
+        if (boxSquareDistance(boundary, other->boundary) > squareDistance)
+        {
+            return;
+        }
+        for (PointType& own : points)
+        {
+            for (auto& pt : other->points)
+            {
+                if (own.squareDistance(pt) <= squareDistance)
+                {
+                    if constexpr (ownOnB) { callback(&pt, &own); }
+                    else { callback(&own, &pt); }
+                }
+            }
+        }
+        if (other->divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                joinOwnPoints<ownOnB>(other->children[i], squareDistance, callback);
+            }
+        }
+    }
+
+    template <int D, typename uT, typename cT>
+    template <typename Callback>
+    void Orthtree<D, uT, cT>::selfJoinNodes(double squareDistance, Callback& callback)
+    {
+        QT_STATS_COUNT(JOIN_NODE_PAIRS);
+        selfJoinNodeLevel(squareDistance, callback);
+        if (divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                children[i]->selfJoinNodes(squareDistance, callback);
+                for (int j = i + 1; j < CHILDREN; j++)
+                {
+                    children[i]->joinNodes(children[j], squareDistance, callback);
+                }
+            }
+        }
+    }
+
+    template <int D, typename uT, typename cT>
+    template <typename Callback>
+    void Orthtree<D, uT, cT>::selfJoinNodeLevel(double squareDistance, Callback& callback)
+    {
+        for (int i = 0; i < points.size(); i++)
+        {
+            for (int j = i + 1; j < points.size(); j++)
+            {
+                if (points[i].squareDistance(points[j]) <= squareDistance)
+                {
+                    callback(&points[i], &points[j]);
+                }
+            }
+        }
+        if (divided)
+        {
+            for (int i = 0; i < CHILDREN; i++)
+            {
+                joinOwnPoints<false>(children[i], squareDistance, callback);
+            }
+        }
+    }
+
+    // Parallel joins: the top node pairs are expanded breadth first (here) until there are enough independent pairs,
+    // which are then joined by the worker threads
+    template <int D, typename uT, typename cT>
+    template <typename oT, typename ocT, typename Callback>
+    void Orthtree<D, uT, cT>::spatialJoin(Orthtree<D, oT, ocT>& other, double distance, Callback callback, int threads)
+    {
+        double squareDistance = distance * distance;
+        if (threads <= 1)
+        {
+            joinNodes(&other, squareDistance, callback);
+            return;
+        }
+
+        std::vector<std::pair<Orthtree*, Orthtree<D, oT, ocT>*>> tasks = { { this, &other } };
+        bool expanded = true;
+        while (expanded && tasks.size() < 4 * threads)
+        {
+            expanded = false;
+            std::vector<std::pair<Orthtree*, Orthtree<D, oT, ocT>*>> nextTasks;
+            for (auto [a, b] : tasks)
+            {
+                if (!a->divided || !b->divided)
+                {
+                    nextTasks.push_back({ a, b });
+                    continue;
+                }
+                QT_STATS_COUNT(JOIN_NODE_PAIRS);
+                if (boxSquareDistance(a->boundary, b->boundary) > squareDistance)
+                {
+                    continue;
+                }
+                a->joinNodeLevel(b, squareDistance, callback);
+                for (int i = 0; i < CHILDREN; i++)
+                {
+                    for (int j = 0; j < CHILDREN; j++)
+                    {
+                        nextTasks.push_back({ a->children[i], b->children[j] });
+                    }
+                }
+                expanded = true;
+            }
+            tasks.swap(nextTasks);
+        }
+
+        std::atomic<size_t> nextTask(0);
+        auto worker = [&]() {
+            for (size_t i = nextTask++; i < tasks.size(); i = nextTask++)
+            {
+                tasks[i].first->joinNodes(tasks[i].second, squareDistance, callback);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int i = 1; i < threads; i++)
+        {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : pool)
+        {
+            thread.join();
+        }
+    }
+
+    template <int D, typename uT, typename cT>
+    template <typename Callback>
+    void Orthtree<D, uT, cT>::selfJoin(double distance, Callback callback, int threads)
+    {
+        double squareDistance = distance * distance;
+        if (threads <= 1)
+        {
+            selfJoinNodes(squareDistance, callback);
+            return;
+        }
+
+        // A task with no second node is the self join of its first node
+        std::vector<std::pair<Orthtree*, Orthtree*>> tasks = { { this, nullptr } };
+        bool expanded = true;
+        while (expanded && tasks.size() < 4 * threads)
+        {
+            expanded = false;
+            std::vector<std::pair<Orthtree*, Orthtree*>> nextTasks;
+            for (auto [a, b] : tasks)
+            {
+                if (!a->divided || (b != nullptr && !b->divided))
+                {
+                    nextTasks.push_back({ a, b });
+                    continue;
+                }
+                QT_STATS_COUNT(JOIN_NODE_PAIRS);
+                if (b == nullptr)
+                {
+                    a->selfJoinNodeLevel(squareDistance, callback);
+                    for (int i = 0; i < CHILDREN; i++)
+                    {
+                        nextTasks.push_back({ a->children[i], nullptr });
+                        for (int j = i + 1; j < CHILDREN; j++)
+                        {
+                            nextTasks.push_back({ a->children[i], a->children[j] });
+                        }
+                    }
+                }
+                else
+                {
+                    if (boxSquareDistance(a->boundary, b->boundary) > squareDistance)
+                    {
+                        continue;
+                    }
+                    a->joinNodeLevel(b, squareDistance, callback);
+                    for (int i = 0; i < CHILDREN; i++)
+                    {
+                        for (int j = 0; j < CHILDREN; j++)
+                        {
+                            nextTasks.push_back({ a->children[i], b->children[j] });
+                        }
+                    }
+                }
+                expanded = true;
+            }
+            tasks.swap(nextTasks);
+        }
+
+        std::atomic<size_t> nextTask(0);
+        auto worker = [&]() {
+            for (size_t i = nextTask++; i < tasks.size(); i = nextTask++)
+            {
+                if (tasks[i].second == nullptr) { tasks[i].first->selfJoinNodes(squareDistance, callback); }
+                else { tasks[i].first->joinNodes(tasks[i].second, squareDistance, callback); }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int i = 1; i < threads; i++)
+        {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : pool)
+        {
+            thread.join();
+        }
+    }
+
+    // Compute statistics of the whole (sub)tree rooted at this node
+    template <int D, typename uT, typename cT>
+    TreeStats Orthtree<D, uT, cT>::getTreeStats() const
+    {
+        TreeStats stats;
+        long long leafDepthSum = 0;
+        std::stack<const Orthtree*> toVisit;
+        toVisit.push(this);
+        while (!toVisit.empty())
+        {
+            const Orthtree* node = toVisit.top();
+            toVisit.pop();
+            int relativeDepth = node->depth - depth;
+            stats.nodeCount++;
+            stats.memoryBytes += sizeof(Orthtree) + node->points.capacity() * sizeof(PointType) + node->multiplicities.capacity() * sizeof(int);
+            if (relativeDepth > stats.maxDepth) { stats.maxDepth = relativeDepth; }
+            if (node->divided)
+            {
+                for (int i = CHILDREN - 1; i >= 0; i--)
+                {
+                    toVisit.push(node->children[i]);
+                }
+                continue;
+            }
+            // Leaf
+            stats.leafCount++;
+            leafDepthSum += relativeDepth;
+            size_t occupancy = node->points.size();
+            if (occupancy == 0) { stats.emptyLeafCount++; }
+            if (stats.leafOccupancy.size() <= occupancy) { stats.leafOccupancy.resize(occupancy + 1, 0); }
+            stats.leafOccupancy[occupancy]++;
+        }
+        stats.meanLeafDepth = static_cast<double>(leafDepthSum) / stats.leafCount;
+        return stats;
+    }
+
+
+    // Face neighbour along an axis (same or bigger size than the node, nullptr on the border of the tree)
+    // Go up until the node is on the other side of the axis than the requested direction, take the sibling across it,
+    // then go down on the side facing the node, following the node's position on the other axes (no path to record)
+    template <int D, typename uT, typename cT>
+    Orthtree<D, uT, cT>* Orthtree<D, uT, cT>::getNeighbour(int axis, bool positive)
+    {
+        int axisBit = 1 << axis;
+        std::array<double, D> c;
+        for (int a = 0; a < D; a++)
+        {
+            c[a] = (OrthtreeSpace<D>::coord(OrthtreeSpace<D>::lower(boundary), a) + OrthtreeSpace<D>::coord(OrthtreeSpace<D>::upper(boundary), a)) / 2;
+        }
+        PointType center = OrthtreeSpace<D>::makePoint(c);
+        Orthtree* node = this;
+        while (node->type != ROOT)
+        {
+            int index = node->type - 1;
+            bool onUpperSide = (index & axisBit) != 0;
+            if (onUpperSide != positive)
+            {
+                Orthtree* currentNode = node->parent->children[index ^ axisBit];
+                while (currentNode->divided && currentNode->depth < depth)
+                {
+                    int childIndex = OrthtreeSpace<D>::childIndex(currentNode->boundary, center);
+                    currentNode = currentNode->children[positive ? (childIndex & ~axisBit) : (childIndex | axisBit)];
+                }
+                return currentNode;
+            }
+            node = node->parent;
+        }
+        return nullptr;
+    }
+
+    // Extended neighbours: the nodes owning the centers of the same size boxes around this one, searched from the root
+    // down to the depth of this node (so diagonal neighbours are found even when the face neighbours are bigger)
+    template <int D, typename uT, typename cT>
+    std::vector<Orthtree<D, uT, cT>*> Orthtree<D, uT, cT>::getExtendedNeighbours()
+    {
+        Orthtree* root = this;
+        while (root->parent != nullptr)
+        {
+            root = root->parent;
+        }
+
+        std::array<double, D> center, size;
+        for (int axis = 0; axis < D; axis++)
+        {
+            double lower = OrthtreeSpace<D>::coord(OrthtreeSpace<D>::lower(boundary), axis);
+            double upper = OrthtreeSpace<D>::coord(OrthtreeSpace<D>::upper(boundary), axis);
+            center[axis] = (lower + upper) / 2;
+            size[axis] = upper - lower;
+        }
+
+        std::vector<Orthtree*> neighbours;
+        int directions = 1;
+        for (int axis = 0; axis < D; axis++)
+        {
+            directions *= 3;
+        }
+        for (int direction = 0; direction < directions; direction++)
+        {
+            // Digit a of direction (base 3) is the offset along axis a: 0 = lower, 1 = same, 2 = upper
+            std::array<double, D> probe;
+            bool isSelf = true;
+            for (int axis = 0, digits = direction; axis < D; axis++, digits /= 3)
+            {
+                int offset = digits % 3 - 1;
+                probe[axis] = center[axis] + offset * size[axis];
+                isSelf = isSelf && offset == 0;
+            }
+            PointType probePoint = OrthtreeSpace<D>::makePoint(probe);
+            if (isSelf || !root->boundary.contains(probePoint))
+            {
+                continue;
+            }
+            Orthtree* node = root;
+            while (node->divided && node->depth < depth)
+            {
+                node = node->getChild(node->getQuadrant(probePoint));
+            }
+            // A bigger neighbour covers several directions, list it once
+            if (std::find(neighbours.begin(), neighbours.end(), node) == neighbours.end())
+            {
+                neighbours.push_back(node);
+            }
+        }
+        return neighbours;
+    }
+
+    // Balance function
+    template <int D, typename uT, typename cT>
+    void Orthtree<D, uT, cT>::balance()
+    {
+        std::queue<Orthtree*> leafsToBalance;
+        this->getLeafs(&leafsToBalance);
+
+        while (!leafsToBalance.empty())
+        {
+            Orthtree* node = leafsToBalance.front();
+            leafsToBalance.pop();
+
+            auto checkAndSubdivide = [&](Orthtree* neighbour) {
+                if (neighbour != nullptr && node->depth - neighbour->depth > 1)
+                {
+                    if (!neighbour->isDivided())
+                    {
+                        neighbour->subdivide();
+                        QT_STATS_COUNT(BALANCE_SUBDIVISIONS);
+                    }
+                    for (int i = 0; i < CHILDREN; i++)
+                    {
+                        leafsToBalance.push(neighbour->children[i]);
+                    }
+                }
+            };
+
+            // Check the leaf's face neighbours
+            for (int axis = 0; axis < D; axis++)
+            {
+                checkAndSubdivide(node->getNeighbour(axis, false));
+                checkAndSubdivide(node->getNeighbour(axis, true));
+            }
+        }
+    }
+
+}
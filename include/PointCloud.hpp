@@ -4,7 +4,8 @@
 * 1. Header (int) - number of frames
 * --- REPEATS FOR ALL FRAMES ---
 * 2. Number of points (int) of frame
-* -- Points (x, y, z) of i-th frame
+* -- Points (x, y) of i-th frame, or (x, y, z) for 3D point clouds (the file does not store the dimension, readers throw if the file size does not match theirs)
+* 3D point clouds are single frame only, temporal point clouds are 2D.
 */
 
 #ifndef POINTCLOUD_HPP
@@ -20,6 +21,9 @@ namespace sim
 	void readPointCloud(std::string path_to_file, PointCloud* point_cloud); // Read point cloud from .pc file, not temporal PointCloud (only 1 frame)
 	void savePointCloud(std::string path_to_file, PointCloud point_cloud); // Save point cloud to .pc file, not temporal PointCloud (only 1 frame)
 
+	void readPointCloud(std::string path_to_file, PointCloud3* point_cloud); // Read 3D point cloud from .pc file (only 1 frame)
+	void savePointCloud(std::string path_to_file, PointCloud3 point_cloud); // Save 3D point cloud to .pc file (only 1 frame)
+
 	void readPointCloud(std::string path_to_file, TemporalPointCloud* temporal_point_cloud); // Read point cloud from .pc file, temporal PointCloud (multiple frames)
 	void savePointCloud(std::string path_to_file, TemporalPointCloud* temporal_point_cloud); // Save point cloud to .pc file, temporal PointCloud (multiple frames)
 }
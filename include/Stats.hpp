@@ -0,0 +1,79 @@
+/*Tree statistics and hot-path counters*/
+
+/*Tree statistics (TreeStats) are computed on demand by Quadtree::getTreeStats() and are always available.
+* Hot-path counters are opt-in: they are compiled only when QUADTREE_STATS is defined (cmake -DQUADTREE_STATS=ON),
+* otherwise QT_STATS_COUNT expands to nothing and has no cost.
+* Each thread increments its own counters (no contention), getCounters() sums them over all threads, including exited ones.
+*/
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <vector>
+#include <array>
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+namespace sim
+{
+    // --- TREE STATISTICS ---
+    typedef struct TreeStats
+    {
+        int nodeCount = 0;
+        int leafCount = 0;
+        int emptyLeafCount = 0;
+        int maxDepth = 0;
+        double meanLeafDepth = 0;
+        std::vector<int> leafOccupancy; // leafOccupancy[n] = number of leafs holding n points
+        size_t memoryBytes = 0; // Nodes plus allocated point storage
+
+        double emptyLeafRatio() const { return leafCount > 0 ? static_cast<double>(emptyLeafCount) / leafCount : 0; }
+        std::string toJson() const;
+    } TreeStats;
+
+    namespace stats
+    {
+        // --- HOT-PATH COUNTERS ---
+        enum Counter
+        {
+            RANGE_QUERIES, // Calls to queryRange
+            QUERY_NODES_VISITED, // Nodes visited by queryRange
+            INSERT_CALLS, // Points passed to insert and bulkInsert (stored, merged or outside the tree)
+            INSERTED_POINTS, // Points stored by insert
+            IS_CROWDED_EVALUATIONS, // isCrowded evaluations during insert
+            SUBDIVISIONS, // All subdivisions
+            BALANCE_SUBDIVISIONS, // Subdivisions done by balance
+            JOIN_NODE_PAIRS, // Node pairs visited by spatialJoin and selfJoin
+            MERGES, // Subdivisions undone by merge
+            FIELD_EVALUATIONS, // Field function calls of the adaptive refinement (cache misses)
+            COUNTER_COUNT
+        };
+
+        typedef std::array<uint64_t, COUNTER_COUNT> Counters;
+
+        // Counters of a single thread, registered for aggregation for the whole life of the thread
+        struct ThreadCounters
+        {
+            std::array<std::atomic<uint64_t>, COUNTER_COUNT> values;
+
+            ThreadCounters();
+            ~ThreadCounters(); // Fold the values into the exited threads total
+        };
+
+        ThreadCounters& localCounters(); // Counters of the calling thread
+        Counters getCounters(); // Sum of the counters of all threads
+        void resetCounters(); // Set all counters of all threads to zero
+        const char* counterName(Counter counter);
+        std::string toJson(const Counters& counters);
+    } // namespace stats
+
+} // namespace sim
+
+#ifdef QUADTREE_STATS
+#define QT_STATS_COUNT(counter) (sim::stats::localCounters().values[sim::stats::counter].fetch_add(1, std::memory_order_relaxed))
+#else
+#define QT_STATS_COUNT(counter) ((void)0)
+#endif
+
+#endif // STATS_HPP
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <memory>
+#include <cmath>
 
 namespace sim
 {
@@ -45,12 +46,12 @@ namespace sim
         BoundingBox(Point topLeft, Point bottomRight) : topLeft(topLeft), bottomRight(bottomRight) {}
         // Methods
         // Check if a point is inside this bounding box
-        bool contains(Point pt)
+        bool contains(Point pt) const
         {
             return (pt.x >= topLeft.x && pt.x <= bottomRight.x && pt.y >= topLeft.y && pt.y <= bottomRight.y);
         }
         // Check if two bounding boxes intersect
-        bool intersects(BoundingBox other)
+        bool intersects(BoundingBox other) const
         {
 			if (other.topLeft.x > bottomRight.x || other.bottomRight.x < topLeft.x)
 				return false;
@@ -63,6 +64,59 @@ namespace sim
         double getHeight() const { return bottomRight.y - topLeft.y; }
     } Bounding;
 
+    // --- FOR OCTREE ---
+    typedef struct Point3
+    {
+        double x;
+        double y;
+        double z;
+        Point3(double x, double y, double z) : x(x), y(y), z(z) {}
+
+        // Methods
+        double squareDistance(Point3 other)
+        {
+            return pow(x - other.x, 2) + pow(y - other.y, 2) + pow(z - other.z, 2);
+        }
+        double distance(Point3 other)
+        {
+            return sqrt(squareDistance(other));
+        }
+
+        // Operators
+        bool operator==(const Point3& other) const
+        {
+            return (x == other.x && y == other.y && z == other.z);
+        }
+    } Point3;
+
+    typedef struct BoundingBox3
+    {
+        Point3 minCorner;
+        Point3 maxCorner;
+        BoundingBox3(Point3 minCorner, Point3 maxCorner) : minCorner(minCorner), maxCorner(maxCorner) {}
+        // Methods
+        // Check if a point is inside this bounding box
+        bool contains(Point3 pt) const
+        {
+            return (pt.x >= minCorner.x && pt.x <= maxCorner.x && pt.y >= minCorner.y && pt.y <= maxCorner.y && pt.z >= minCorner.z && pt.z <= maxCorner.z);
+        }
+        // Check if two bounding boxes intersect
+        bool intersects(BoundingBox3 other) const
+        {
+            if (other.minCorner.x > maxCorner.x || other.maxCorner.x < minCorner.x)
+                return false;
+            if (other.minCorner.y > maxCorner.y || other.maxCorner.y < minCorner.y)
+                return false;
+            if (other.minCorner.z > maxCorner.z || other.maxCorner.z < minCorner.z)
+                return false;
+            return true;
+        }
+        // Getters
+        double getWidth() const { return maxCorner.x - minCorner.x; }
+        double getHeight() const { return maxCorner.y - minCorner.y; }
+        double getDepth() const { return maxCorner.z - minCorner.z; }
+    } BoundingBox3;
+
     // --- FOR POINT CLOUD ---
     // Point cloud is just a simple collection (vector) of points
     typedef struct PointCloud
@@ -81,6 +135,22 @@ namespace sim
 
     } PointCloud;
 
+    typedef struct PointCloud3
+    {
+        std::vector<Point3> points;
+
+        // Constructors
+        PointCloud3(std::vector<Point3> points) : points(points) {}
+        PointCloud3() {} // Empty constructor
+        // Getters
+        int size() const { return points.size(); }
+        Point3 operator[](int i) const { return points[i]; }
+        Point3 at(int i) const { return points.at(i); }
+        // Setters
+        void push_back(Point3 pt) { points.push_back(pt); }
+
+    } PointCloud3;
+
     typedef struct TemporalPointCloud
     {
         std::vector<PointCloud> frames;
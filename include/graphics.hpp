@@ -3,10 +3,10 @@
 
 #include <SFML/Graphics.hpp>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include "MeshGeneration.hpp"
 
-template <typename uT, typename cT> class sim::Quadtree;
-
 template <typename uT, typename cT>
 sim::Quadtree<uT, cT>* selectNode(float x, float y, sim::Quadtree<uT, cT>* qt); // Select a node from the quadtree based on x and y coordinates
 
@@ -25,6 +25,44 @@ void rwToImage(const sf::RenderWindow& window, const std::string& filename); //
 template <typename uT, typename cT>
 void quadtreeToImage(const sim::Quadtree<uT, cT>& qt, const std::string& filename); // Save the quadtree to an image
 
+template <typename uT, typename cT>
+void quadtreeToImage(sim::Quadtree<uT, cT>& qt, const sim::Mesh& mesh, const std::string& filename); // Save the quadtree and the mesh to an image
+
+// Batched renderer: one cached vertex array per layer, rebuilt only when invalidated or when the view changes
+// The same vertex arrays are drawn on a render target (live viewer) or rasterized on the CPU into an image (headless, no window needed)
+template <typename uT, typename cT>
+class QuadtreeRenderer
+{
+public:
+    enum Layer { NODES, LEAFS, POINTS, MESH, LAYER_COUNT };
+
+    QuadtreeRenderer(sim::Quadtree<uT, cT>& qt, const sim::Mesh* mesh = nullptr);
+
+    void invalidate() { for (bool& d : dirty) { d = true; } } // Call after the quadtree changed (insert, balance, ...)
+    void invalidateMesh() { dirty[MESH] = true; } // Call after the mesh changed
+    void setView(sim::BoundingBox view); // Only what intersects the view is built (culling)
+    void setLayerVisible(Layer layer, bool show) { visible[layer] = show; }
+    bool isLayerVisible(Layer layer) const { return visible[layer]; }
+
+    void draw(sf::RenderTarget& target); // Draw the visible layers
+    void renderToImage(sf::Image& image, sf::Color background = sf::Color::Black); // Rasterize the visible layers, image has the size of the view
+
+private:
+    sim::Quadtree<uT, cT>& qt;
+    const sim::Mesh* mesh;
+    sim::BoundingBox view;
+    sf::VertexArray layers[LAYER_COUNT];
+    bool dirty[LAYER_COUNT];
+    bool visible[LAYER_COUNT];
+
+    const sf::VertexArray& getLayer(Layer layer); // Rebuild the layer if needed
+    void buildNodes(sim::Quadtree<uT, cT>* node, sf::VertexArray& nodes, sf::VertexArray& leafs); // Culled traversal filling both node and leaf layers
+};
+
+void appendRectangle(sf::VertexArray& vertices, float left, float top, float width, float height, sf::Color color); // Append the outline of a rectangle (sf::Lines)
+void appendPoint(sf::VertexArray& vertices, float x, float y, float size, sf::Color color); // Append a square point of side 2 * size (sf::Triangles)
+void rasterizeVertexArray(const sf::VertexArray& vertices, sf::Image& image, sf::Vector2f origin); // Software rasterization of sf::Lines and sf::Triangles
+
 template <typename uT, typename cT>
 void quadtreeLive(sim::Quadtree<uT, cT>& qt, sim::Mesh& mesh); // Live quadtree
 
@@ -3,18 +3,7 @@ sim::Quadtree<uT, cT>* selectNode(float x, float y, sim::Quadtree<uT, cT>* qt)
 {
     sim::Point point(x, y);
     if (qt->isDivided()) {
-        if (qt->getNorthWest()->getBoundary().contains(point)) {
-			return selectNode(x, y, qt->getNorthWest());
-		}
-        else if (qt->getNorthEast()->getBoundary().contains(point)) {
-			return selectNode(x, y, qt->getNorthEast());
-		}
-        else if (qt->getSouthWest()->getBoundary().contains(point)) {
-			return selectNode(x, y, qt->getSouthWest());
-		}
-        else if (qt->getSouthEast()->getBoundary().contains(point)) {
-			return selectNode(x, y, qt->getSouthEast());
-		}
+        return selectNode(x, y, qt->getChild(qt->getQuadrant(point)));
 	}
     std::cout << "Selected node (x,y): " << qt->getBoundary().topLeft.x << ", " << qt->getBoundary().topLeft.y << std::endl;
     return qt;
@@ -98,10 +87,217 @@ void rwToImage(const sf::RenderWindow& window, const std::string& filename)
 
 template <typename uT, typename cT>
 void quadtreeToImage(sim::Quadtree<uT, cT>& qt, const std::string& filename) {
-    sf::RenderWindow window(sf::VideoMode(qt.getBoundary().getWidth(), qt.getBoundary().getHeight()), "Quadtree");
-    window.clear(sf::Color::Black);
-    drawQuadtree(qt, window);
-    rwToImage(window, filename);
+    // Headless: rasterized on the CPU, no window is opened
+    QuadtreeRenderer<uT, cT> renderer(qt);
+    sf::Image image;
+    renderer.renderToImage(image);
+    image.saveToFile(filename);
+}
+
+template <typename uT, typename cT>
+void quadtreeToImage(sim::Quadtree<uT, cT>& qt, const sim::Mesh& mesh, const std::string& filename) {
+    QuadtreeRenderer<uT, cT> renderer(qt, &mesh);
+    renderer.setLayerVisible(QuadtreeRenderer<uT, cT>::MESH, true);
+    sf::Image image;
+    renderer.renderToImage(image);
+    image.saveToFile(filename);
+}
+
+// --- Batched renderer ---
+void appendRectangle(sf::VertexArray& vertices, float left, float top, float width, float height, sf::Color color)
+{
+    sf::Vector2f corners[4] = {
+        sf::Vector2f(left, top),
+        sf::Vector2f(left + width, top),
+        sf::Vector2f(left + width, top + height),
+        sf::Vector2f(left, top + height)
+    };
+    for (int i = 0; i < 4; i++) {
+        vertices.append(sf::Vertex(corners[i], color));
+        vertices.append(sf::Vertex(corners[(i + 1) % 4], color));
+    }
+}
+
+void appendPoint(sf::VertexArray& vertices, float x, float y, float size, sf::Color color)
+{
+    sf::Vector2f topLeft(x - size, y - size), topRight(x + size, y - size), bottomRight(x + size, y + size), bottomLeft(x - size, y + size);
+    vertices.append(sf::Vertex(topLeft, color));
+    vertices.append(sf::Vertex(topRight, color));
+    vertices.append(sf::Vertex(bottomRight, color));
+    vertices.append(sf::Vertex(topLeft, color));
+    vertices.append(sf::Vertex(bottomRight, color));
+    vertices.append(sf::Vertex(bottomLeft, color));
+}
+
+void rasterizeVertexArray(const sf::VertexArray& vertices, sf::Image& image, sf::Vector2f origin)
+{
+    int width = image.getSize().x;
+    int height = image.getSize().y;
+    auto setPixel = [&](int x, int y, sf::Color color) {
+        if (x >= 0 && y >= 0 && x < width && y < height) {
+            image.setPixel(x, y, color);
+        }
+    };
+
+    if (vertices.getPrimitiveType() == sf::Lines) {
+        // Bresenham, one color per line (the one of its first vertex)
+        for (size_t i = 0; i + 1 < vertices.getVertexCount(); i += 2) {
+            int x0 = static_cast<int>(std::floor(vertices[i].position.x - origin.x));
+            int y0 = static_cast<int>(std::floor(vertices[i].position.y - origin.y));
+            int x1 = static_cast<int>(std::floor(vertices[i + 1].position.x - origin.x));
+            int y1 = static_cast<int>(std::floor(vertices[i + 1].position.y - origin.y));
+            int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+            int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+            int err = dx + dy;
+            while (true) {
+                setPixel(x0, y0, vertices[i].color);
+                if (x0 == x1 && y0 == y1) break;
+                int e2 = 2 * err;
+                if (e2 >= dy) { err += dy; x0 += sx; }
+                if (e2 <= dx) { err += dx; y0 += sy; }
+            }
+        }
+    }
+    else if (vertices.getPrimitiveType() == sf::Triangles) {
+        // Fill pixel centers inside the triangle (edge functions over its bounding box)
+        for (size_t i = 0; i + 2 < vertices.getVertexCount(); i += 3) {
+            sf::Vector2f a = vertices[i].position - origin, b = vertices[i + 1].position - origin, c = vertices[i + 2].position - origin;
+            auto edge = [](sf::Vector2f p, sf::Vector2f q, float x, float y) { return (q.x - p.x) * (y - p.y) - (q.y - p.y) * (x - p.x); };
+            float area = edge(a, b, c.x, c.y);
+            if (area == 0) continue;
+            int minX = std::max(0, static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))));
+            int maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))));
+            int minY = std::max(0, static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))));
+            int maxY = std::min(height - 1, static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))));
+            for (int y = minY; y <= maxY; y++) {
+                for (int x = minX; x <= maxX; x++) {
+                    float px = x + 0.5f, py = y + 0.5f;
+                    float w0 = edge(b, c, px, py) / area, w1 = edge(c, a, px, py) / area, w2 = edge(a, b, px, py) / area;
+                    if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
+                        setPixel(x, y, vertices[i].color);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename uT, typename cT>
+QuadtreeRenderer<uT, cT>::QuadtreeRenderer(sim::Quadtree<uT, cT>& qt, const sim::Mesh* mesh)
+    : qt(qt), mesh(mesh), view(qt.getBoundary())
+{
+    layers[NODES].setPrimitiveType(sf::Lines);
+    layers[LEAFS].setPrimitiveType(sf::Lines);
+    layers[POINTS].setPrimitiveType(sf::Triangles);
+    layers[MESH].setPrimitiveType(sf::Lines);
+    for (int i = 0; i < LAYER_COUNT; i++) {
+        dirty[i] = true;
+    }
+    // Same defaults as the live viewer: quadtree (nodes and points) on, leafs and mesh off
+    visible[NODES] = true;
+    visible[POINTS] = true;
+    visible[LEAFS] = false;
+    visible[MESH] = false;
+}
+
+template <typename uT, typename cT>
+void QuadtreeRenderer<uT, cT>::setView(sim::BoundingBox newView)
+{
+    if (newView.topLeft == view.topLeft && newView.bottomRight == view.bottomRight) {
+        return;
+    }
+    view = newView;
+    invalidate();
+}
+
+template <typename uT, typename cT>
+void QuadtreeRenderer<uT, cT>::buildNodes(sim::Quadtree<uT, cT>* node, sf::VertexArray& nodes, sf::VertexArray& leafs)
+{
+    sim::BoundingBox boundary = node->getBoundary();
+    if (!boundary.intersects(view)) {
+        return;
+    }
+    appendRectangle(nodes, boundary.topLeft.x, boundary.topLeft.y, boundary.getWidth(), boundary.getHeight(), sf::Color::Green);
+    if (node->isDivided()) {
+        buildNodes(node->getNorthWest(), nodes, leafs);
+        buildNodes(node->getNorthEast(), nodes, leafs);
+        buildNodes(node->getSouthWest(), nodes, leafs);
+        buildNodes(node->getSouthEast(), nodes, leafs);
+    }
+    else {
+        // Leafs are drawn 4 pixels inside their boundary, colored by depth (same as drawLeafs)
+        sf::Color color(255 - node->getDepth() * 30, 0, 255 + node->getDepth() * 35, 255);
+        appendRectangle(leafs, boundary.topLeft.x + 4, boundary.topLeft.y + 4, boundary.getWidth() - 8, boundary.getHeight() - 8, color);
+    }
+}
+
+template <typename uT, typename cT>
+const sf::VertexArray& QuadtreeRenderer<uT, cT>::getLayer(Layer layer)
+{
+    if (!dirty[layer]) {
+        return layers[layer];
+    }
+    switch (layer) {
+    case NODES:
+    case LEAFS:
+        // One traversal builds both
+        layers[NODES].clear();
+        layers[LEAFS].clear();
+        buildNodes(&qt, layers[NODES], layers[LEAFS]);
+        dirty[NODES] = false;
+        dirty[LEAFS] = false;
+        break;
+    case POINTS:
+        layers[POINTS].clear();
+        for (const sim::Point* pt : qt.queryRange(view)) {
+            appendPoint(layers[POINTS], pt->x, pt->y, 2, sf::Color::White);
+        }
+        dirty[POINTS] = false;
+        break;
+    case MESH:
+        layers[MESH].clear();
+        if (mesh != nullptr) {
+            for (const auto& link : mesh->links) {
+                // Cull links whose bounding box is outside the view
+                sim::BoundingBox linkBox(sim::Point(std::min(link.p1->x, link.p2->x), std::min(link.p1->y, link.p2->y)),
+                    sim::Point(std::max(link.p1->x, link.p2->x), std::max(link.p1->y, link.p2->y)));
+                if (linkBox.intersects(view)) {
+                    layers[MESH].append(sf::Vertex(sf::Vector2f(link.p1->x, link.p1->y), sf::Color::White));
+                    layers[MESH].append(sf::Vertex(sf::Vector2f(link.p2->x, link.p2->y), sf::Color::White));
+                }
+            }
+        }
+        dirty[MESH] = false;
+        break;
+    default:
+        break;
+    }
+    return layers[layer];
+}
+
+template <typename uT, typename cT>
+void QuadtreeRenderer<uT, cT>::draw(sf::RenderTarget& target)
+{
+    // One draw call per visible layer, in the same order as the live viewer used to draw them
+    const Layer order[LAYER_COUNT] = { NODES, POINTS, LEAFS, MESH };
+    for (Layer layer : order) {
+        if (visible[layer]) {
+            target.draw(getLayer(layer));
+        }
+    }
+}
+
+template <typename uT, typename cT>
+void QuadtreeRenderer<uT, cT>::renderToImage(sf::Image& image, sf::Color background)
+{
+    image.create(static_cast<unsigned int>(view.getWidth()), static_cast<unsigned int>(view.getHeight()), background);
+    sf::Vector2f origin(view.topLeft.x, view.topLeft.y);
+    const Layer order[LAYER_COUNT] = { NODES, POINTS, LEAFS, MESH };
+    for (Layer layer : order) {
+        if (visible[layer]) {
+            rasterizeVertexArray(getLayer(layer), image, origin);
+        }
+    }
 }
 
 template <typename uT, typename cT>
@@ -109,10 +305,8 @@ void quadtreeLive(sim::Quadtree<uT, cT>& qt, sim::Mesh& mesh) {
     sf::RenderWindow window(sf::VideoMode(qt.getBoundary().getWidth(), qt.getBoundary().getHeight()), "Quadtree");
     window.setVerticalSyncEnabled(true); // Ensure rendering is synced with the display's refresh rate to avoid tearing
 
-    bool shouldDrawLeafs = false;
+    QuadtreeRenderer<uT, cT> renderer(qt, &mesh); // Cached layers, invalidated whenever the quadtree or the mesh change
     bool shouldDrawNeighbours = false;
-    bool shouldDrawMesh = false;
-    bool shouldDrawQuadtree = true;
     sim::Quadtree<uT, cT>* nodeForNeighbours = nullptr;
     sim::Quadtree<uT, cT>* neighboursAndNodeList[5];
     bool selectionMode = false;
@@ -133,11 +327,13 @@ void quadtreeLive(sim::Quadtree<uT, cT>& qt, sim::Mesh& mesh) {
                 float x = static_cast<float>(event.mouseButton.x);
                 float y = static_cast<float>(event.mouseButton.y);
                 qt.insert(sim::Point(x, y)); // Insert the point into the Quadtree
+                renderer.invalidate();
             }
 
             // Handle "B" key press to balance the Quadtree
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B) {
                 qt.balance();
+                renderer.invalidate();
                 std::cout << "Quadtree balanced" << std::endl;
             }
 
@@ -155,22 +351,25 @@ void quadtreeLive(sim::Quadtree<uT, cT>& qt, sim::Mesh& mesh) {
 
             // Handle "L" key press to toggle the drawing of leafs
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::L) {
-                shouldDrawLeafs = !shouldDrawLeafs;
+                renderer.setLayerVisible(QuadtreeRenderer<uT, cT>::LEAFS, !renderer.isLayerVisible(QuadtreeRenderer<uT, cT>::LEAFS));
             }
 
             // Handle "M" key press to toggle the drawing of the mesh
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::M) {
-				shouldDrawMesh = !shouldDrawMesh;
+				renderer.setLayerVisible(QuadtreeRenderer<uT, cT>::MESH, !renderer.isLayerVisible(QuadtreeRenderer<uT, cT>::MESH));
 			}
             // CTRL + M to regenerate the mesh
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::M && sf::Keyboard::isKeyPressed(sf::Keyboard::LControl)) {
                 mesh = sim::generateMesh2(&qt);
+                renderer.invalidateMesh();
                 std::cout << "Mesh regenerated" << std::endl;
 			}
 
             // Handle "Q" key press to toggle the drawing of the Quadtree
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Q) {
-                shouldDrawQuadtree = !shouldDrawQuadtree;
+                bool showQuadtree = !renderer.isLayerVisible(QuadtreeRenderer<uT, cT>::NODES);
+                renderer.setLayerVisible(QuadtreeRenderer<uT, cT>::NODES, showQuadtree);
+                renderer.setLayerVisible(QuadtreeRenderer<uT, cT>::POINTS, showQuadtree);
 			}
 
             // Toggle selection mode on "P" key press
@@ -234,25 +433,17 @@ void quadtreeLive(sim::Quadtree<uT, cT>& qt, sim::Mesh& mesh) {
 
         window.clear(sf::Color::Black); // Clear the window
 
-        if (shouldDrawQuadtree) {
-        drawQuadtree(qt, window); // Draw the entire Quadtree
-        }
-
-        // If "L" key has been pressed, draw the leaf nodes
-        if (shouldDrawLeafs) {
-            drawLeafs(&qt, window);
-        }
+        // Cull to the current view, layers are rebuilt only if the view moved
+        sf::Vector2f viewCenter = window.getView().getCenter();
+        sf::Vector2f viewSize = window.getView().getSize();
+        renderer.setView(sim::BoundingBox(sim::Point(viewCenter.x - viewSize.x / 2, viewCenter.y - viewSize.y / 2), sim::Point(viewCenter.x + viewSize.x / 2, viewCenter.y + viewSize.y / 2)));
+        renderer.draw(window); // Draw quadtree, points, leafs and mesh (the visible ones)
 
         // If "N" key has been pressed, draw the neighbours of the selected node
         if (shouldDrawNeighbours && nodeForNeighbours) {
             drawNeighbours(neighboursAndNodeList, window);
         }
 
-        // If "M" key has been pressed, draw the mesh
-        if (shouldDrawMesh) {
-			drawMesh(mesh, window);
-		}
-
         // Draw selection rectangle if in selection mode
         if (selectionMode) {
             window.draw(selectionRectangle);
@@ -2,12 +2,11 @@
 #define UTILITY_HPP
 
 #include "Types.hpp"
+#include "Quadtree.hpp"
 
 #define M_PI 3.14159265358979323846
 
 namespace sim {
-    template <typename uT, typename cT> class Quadtree;
-
     template <typename uT, typename cT>
     bool isCrowded_simple(Quadtree<uT, cT>* quadtree, int capacity)
     {
@@ -22,7 +21,7 @@ namespace sim {
 			return true;
 		}
         //C3 - Box b contains a point of X and one of the extended neighbors of b is split. 
-        std::vector<Quadtree<uT, cT>*> extended_neighbors = quadtree->getExtendedNeighbour();
+        std::vector<Quadtree<uT, cT>*> extended_neighbors = quadtree->getExtendedNeighbours();
         for(auto neighbor : extended_neighbors)
         {
             if (neighbor->isDivided() && neighbor->getPoints().size() > neighbor->getCapacity())
@@ -1,5 +1,25 @@
 #include "PointCloud.hpp"
 
+namespace
+{
+    // The .pc format does not record the dimension, so check that the rest of the file holds exactly nPoints points of it
+    void checkPointCount(std::ifstream& file, int nPoints, int dimension)
+    {
+        if (!file || nPoints < 0)
+        {
+            throw std::runtime_error("Invalid point cloud header");
+        }
+        std::streampos dataBegin = file.tellg();
+        file.seekg(0, std::ios::end);
+        std::streamoff dataSize = file.tellg() - dataBegin;
+        file.seekg(dataBegin);
+        if (dataSize != static_cast<std::streamoff>(nPoints) * dimension * static_cast<std::streamoff>(sizeof(double)))
+        {
+            throw std::runtime_error("Expected " + std::to_string(nPoints) + " points of dimension " + std::to_string(dimension) + ", file size does not match");
+        }
+    }
+}
+
 // --- Single frame point cloud ---
 void sim::readPointCloud(std::string path_to_file, sim::PointCloud* point_cloud)
 {
@@ -11,13 +31,18 @@ void sim::readPointCloud(std::string path_to_file, sim::PointCloud* point_cloud)
     // Read header
     int frames; // Expected to be one for static point cloud version
     file.read((char*)&frames, sizeof(int));
+    if (!file)
+    {
+        throw std::runtime_error("Invalid point cloud header");
+    }
     if (frames != 1)
     {
-        throw std::runtime_error("Expected 1 frame, found " + static_cast<char>(frames));
+        throw std::runtime_error("Expected 1 frame, found " + std::to_string(frames));
     }
     // Read number of points for each frame
     int nPoints;
     file.read((char*)&nPoints, sizeof(int));
+    checkPointCount(file, nPoints, 2);
     // Read points
     for (int i = 0; i < nPoints; i++)
     {
@@ -58,6 +83,72 @@ void sim::savePointCloud(std::string path_to_file, PointCloud point_cloud)
     file.close();
 }
 
+// --- Single frame 3D point cloud ---
+void sim::readPointCloud(std::string path_to_file, sim::PointCloud3* point_cloud)
+{
+    std::ifstream file(path_to_file, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Cannot open file");
+    }
+    // Read header
+    int frames; // Expected to be one for static point cloud version
+    file.read((char*)&frames, sizeof(int));
+    if (!file)
+    {
+        throw std::runtime_error("Invalid point cloud header");
+    }
+    if (frames != 1)
+    {
+        throw std::runtime_error("Expected 1 frame, found " + std::to_string(frames));
+    }
+    // Read number of points for each frame
+    int nPoints;
+    file.read((char*)&nPoints, sizeof(int));
+    checkPointCount(file, nPoints, 3);
+    // Read points
+    for (int i = 0; i < nPoints; i++)
+    {
+        double x, y, z;
+        file.read((char*)&x, sizeof(double));
+        file.read((char*)&y, sizeof(double));
+        file.read((char*)&z, sizeof(double));
+        point_cloud->points.push_back(sim::Point3(x, y, z));
+    }
+
+    // Close file
+    file.close();
+}
+
+void sim::savePointCloud(std::string path_to_file, PointCloud3 point_cloud)
+{
+    // Open or create file
+    std::ofstream file(path_to_file, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Cannot open file");
+    }
+    // Write header
+    int frames = 1; // Expected to be one for static point cloud version
+    file.write((char*)&frames, sizeof(int));
+    // Write number of points for each frame
+    int nPoints = point_cloud.size();
+    file.write((char*)&nPoints, sizeof(int));
+    // Write points
+    for (int i = 0; i < nPoints; i++)
+    {
+        double x = point_cloud[i].x;
+        double y = point_cloud[i].y;
+        double z = point_cloud[i].z;
+        file.write((char*)&x, sizeof(double));
+        file.write((char*)&y, sizeof(double));
+        file.write((char*)&z, sizeof(double));
+    }
+
+    // Close file
+    file.close();
+}
+
 // --- Temporal point cloud ---
 void sim::readPointCloud(std::string path_to_file, sim::TemporalPointCloud* tpc)
 {
@@ -0,0 +1,122 @@
+#include "Stats.hpp"
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+    // Registry of the counters of live threads plus the total of exited threads
+    std::mutex registryMutex;
+    std::vector<sim::stats::ThreadCounters*> liveCounters;
+    sim::stats::Counters exitedTotal = {};
+
+    const char* counterNames[sim::stats::COUNTER_COUNT] = {
+        "rangeQueries",
+        "queryNodesVisited",
+        "insertCalls",
+        "insertedPoints",
+        "isCrowdedEvaluations",
+        "subdivisions",
+        "balanceSubdivisions",
+        "joinNodePairs",
+        "merges",
+        "fieldEvaluations"
+    };
+}
+
+// --- Tree statistics ---
+std::string sim::TreeStats::toJson() const
+{
+    std::ostringstream json;
+    json << "{\"nodeCount\": " << nodeCount
+        << ", \"leafCount\": " << leafCount
+        << ", \"emptyLeafCount\": " << emptyLeafCount
+        << ", \"emptyLeafRatio\": " << emptyLeafRatio()
+        << ", \"maxDepth\": " << maxDepth
+        << ", \"meanLeafDepth\": " << meanLeafDepth
+        << ", \"memoryBytes\": " << memoryBytes
+        << ", \"leafOccupancy\": [";
+    for (size_t i = 0; i < leafOccupancy.size(); i++)
+    {
+        json << (i > 0 ? ", " : "") << leafOccupancy[i];
+    }
+    json << "]}";
+    return json.str();
+}
+
+// --- Hot-path counters ---
+sim::stats::ThreadCounters::ThreadCounters()
+{
+    for (auto& value : values)
+    {
+        value.store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    liveCounters.push_back(this);
+}
+
+sim::stats::ThreadCounters::~ThreadCounters()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        exitedTotal[i] += values[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < liveCounters.size(); i++)
+    {
+        if (liveCounters[i] == this)
+        {
+            liveCounters.erase(liveCounters.begin() + i);
+            break;
+        }
+    }
+}
+
+sim::stats::ThreadCounters& sim::stats::localCounters()
+{
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+sim::stats::Counters sim::stats::getCounters()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    Counters total = exitedTotal;
+    for (ThreadCounters* thread : liveCounters)
+    {
+        for (int i = 0; i < COUNTER_COUNT; i++)
+        {
+            total[i] += thread->values[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+void sim::stats::resetCounters()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    exitedTotal = {};
+    for (ThreadCounters* thread : liveCounters)
+    {
+        for (auto& value : thread->values)
+        {
+            value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char* sim::stats::counterName(Counter counter)
+{
+    return counterNames[counter];
+}
+
+std::string sim::stats::toJson(const Counters& counters)
+{
+    std::ostringstream json;
+    json << "{";
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        json << (i > 0 ? ", " : "") << "\"" << counterNames[i] << "\": " << counters[i];
+    }
+    json << "}";
+    return json.str();
+}
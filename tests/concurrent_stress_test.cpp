@@ -0,0 +1,63 @@
+// Stress test of ConcurrentQuadtree: readers query snapshots while one writer publishes batches
+// Build with -fsanitize=thread or -fsanitize=address to check the copy-on-write and the epoch reclamation
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "ConcurrentOrthtree.hpp"
+
+#define cwidth 1000
+#define cheight 1000
+#define READERS 4
+#define BATCHES 200
+#define BATCH_SIZE 50
+
+
+int main()
+{
+    sim::BoundingBox boundary = sim::BoundingBox(sim::Point(0, 0), sim::Point(cwidth, cheight));
+    sim::ConcurrentQuadtree tree(boundary, 4);
+    std::atomic<bool> writing(true);
+    std::atomic<int> errors(0);
+
+    // Readers: every snapshot must see whole batches only, and never fewer points than an older snapshot
+    std::vector<std::thread> readers;
+    for (int r = 0; r < READERS; r++)
+    {
+        readers.emplace_back([&]() {
+            size_t lastCount = 0;
+            while (writing.load())
+            {
+                auto snapshot = tree.snapshot();
+                size_t count = snapshot.queryRange(boundary).size();
+                if (count % BATCH_SIZE != 0 || count < lastCount)
+                {
+                    errors++;
+                }
+                lastCount = count;
+            }
+        });
+    }
+
+    // Writer: distinct points (no merging), one bulkInsert per batch
+    for (int b = 0; b < BATCHES; b++)
+    {
+        std::vector<sim::Point> batch;
+        for (int i = 0; i < BATCH_SIZE; i++)
+        {
+            int n = b * BATCH_SIZE + i;
+            batch.push_back(sim::Point((n % 100) * 10 + 0.5, (n / 100) * 10 % cheight + 0.5 + b * 1e-3));
+        }
+        tree.bulkInsert(batch);
+    }
+    writing.store(false);
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    size_t total = tree.queryRange(boundary).size();
+    std::cout << "Points: " << total << " (expected " << BATCHES * BATCH_SIZE << "), errors: " << errors.load() << std::endl;
+    return (errors.load() == 0 && total == BATCHES * BATCH_SIZE) ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+// Check spatialJoin and selfJoin against brute force pair loops, single threaded and with the top node pairs split among threads
+// Build with -fsanitize=thread to check the parallel joins
+
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <utility>
+#include "Quadtree.hpp"
+
+#define cwidth 1000
+#define cheight 1000
+#define N_POINTS 2000
+#define DISTANCE 15.0
+
+
+// Join results as (a, b) pointer pairs, counted to detect pairs reported more than once
+struct JoinResult
+{
+    std::mutex mutex;
+    std::set<std::pair<const void*, const void*>> pairs;
+    long count = 0;
+    bool tooFar = false;
+
+    template <typename P>
+    void add(P* a, P* b, bool unordered)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (a->squareDistance(*b) > DISTANCE * DISTANCE)
+        {
+            tooFar = true;
+        }
+        if (unordered && b < a)
+        {
+            std::swap(a, b);
+        }
+        pairs.insert({ a, b });
+        count++;
+    }
+};
+
+template <typename Tree, typename OtherTree, typename P>
+int checkTrees(const char* name, Tree& treeA, OtherTree& treeB, const std::vector<P>& pointsA, const std::vector<P>& pointsB)
+{
+    // Brute force counts (coincident points are unlikely at this resolution, so every stored point has multiplicity 1)
+    long joinPairs = 0;
+    long selfPairs = 0;
+    for (size_t i = 0; i < pointsA.size(); i++)
+    {
+        for (size_t j = 0; j < pointsB.size(); j++)
+        {
+            joinPairs += P(pointsA[i]).squareDistance(pointsB[j]) <= DISTANCE * DISTANCE;
+        }
+        for (size_t j = i + 1; j < pointsA.size(); j++)
+        {
+            selfPairs += P(pointsA[i]).squareDistance(pointsA[j]) <= DISTANCE * DISTANCE;
+        }
+    }
+
+    int errors = 0;
+    for (int threads : { 1, 3, 4, 8 })
+    {
+        JoinResult join;
+        treeA.spatialJoin(treeB, DISTANCE, [&](P* a, P* b) { join.add(a, b, false); }, threads);
+        JoinResult self;
+        treeA.selfJoin(DISTANCE, [&](P* a, P* b) { self.add(a, b, true); }, threads);
+
+        bool ok = join.count == joinPairs && (long)join.pairs.size() == joinPairs && !join.tooFar
+            && self.count == selfPairs && (long)self.pairs.size() == selfPairs && !self.tooFar;
+        std::cout << name << ", " << threads << " threads: join " << join.count << "/" << joinPairs
+            << ", self join " << self.count << "/" << selfPairs << (ok ? "" : " FAILED") << std::endl;
+        errors += !ok;
+    }
+    return errors;
+}
+
+
+int main()
+{
+    srand(7);
+    int errors = 0;
+
+    // Quadtrees with different capacities (and user data types), points are also stored at inner nodes
+    std::vector<sim::Point> pointsA, pointsB;
+    for (int i = 0; i < N_POINTS; i++)
+    {
+        pointsA.push_back(sim::Point(rand() % (cwidth * 100) / 100.0, rand() % (cheight * 100) / 100.0));
+        pointsB.push_back(sim::Point(rand() % (cwidth * 100) / 100.0, rand() % (cheight * 100) / 100.0));
+    }
+    sim::BoundingBox boundary = sim::BoundingBox(sim::Point(0, 0), sim::Point(cwidth, cheight));
+    sim::Quadtree<int, int> quadtreeA(boundary, 2);
+    sim::Quadtree<double, int> quadtreeB(boundary, 5);
+    quadtreeA.bulkInsert(pointsA);
+    quadtreeB.bulkInsert(pointsB);
+    errors += checkTrees("Quadtree", quadtreeA, quadtreeB, pointsA, pointsB);
+
+    // Small max depth: the overflow buckets hold many points
+    sim::Quadtree<int, int> shallowA(boundary, 1);
+    sim::Quadtree<int, int> shallowB(boundary, 1);
+    shallowA.setMaxDepth(3);
+    shallowB.setMaxDepth(3);
+    shallowA.bulkInsert(pointsA);
+    shallowB.bulkInsert(pointsB);
+    errors += checkTrees("Quadtree (max depth 3)", shallowA, shallowB, pointsA, pointsB);
+
+    // Octrees
+    std::vector<sim::Point3> pointsA3, pointsB3;
+    for (int i = 0; i < N_POINTS; i++)
+    {
+        pointsA3.push_back(sim::Point3(rand() % (cwidth * 25) / 100.0, rand() % (cwidth * 25) / 100.0, rand() % (cwidth * 25) / 100.0));
+        pointsB3.push_back(sim::Point3(rand() % (cwidth * 25) / 100.0, rand() % (cwidth * 25) / 100.0, rand() % (cwidth * 25) / 100.0));
+    }
+    sim::BoundingBox3 boundary3 = sim::BoundingBox3(sim::Point3(0, 0, 0), sim::Point3(cwidth / 4.0, cwidth / 4.0, cwidth / 4.0));
+    sim::Octree<int, int> octreeA(boundary3, 3);
+    sim::Octree<int, int> octreeB(boundary3, 3);
+    octreeA.bulkInsert(pointsA3);
+    octreeB.bulkInsert(pointsB3);
+    errors += checkTrees("Octree", octreeA, octreeB, pointsA3, pointsB3);
+
+    std::cout << (errors == 0 ? "All joins match brute force" : "Some joins do not match brute force") << std::endl;
+    return errors == 0 ? 0 : 1;
+}